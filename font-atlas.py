@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Генератор атласа глифов в формате страниц ST7565.
+
+Шрифты Adafruit GFX хранят глиф построчно, по биту на пиксель. Здесь
+каждый глиф перекладывается в столбцы по 8 строк (бит 0 - верхняя строка),
+как байты в gFrameBuffer, чтобы текст рисовался байтовыми операциями.
+
+usage: font-atlas.py OUT.h FONT.h [FONT.h ...]
+"""
+
+import re
+import sys
+
+RE_BITMAPS = re.compile(r"const\s+uint8_t\s+\w+\[\]\s*PROGMEM\s*=\s*\{(.*?)\}\s*;", re.S)
+RE_GLYPHS = re.compile(r"const\s+GFXglyph\s+\w+\[\]\s*PROGMEM\s*=\s*\{(.*?)\}\s*;", re.S)
+RE_GLYPH = re.compile(r"\{\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*\}")
+RE_FONT = re.compile(r"const\s+GFXfont\s+(\w+)\s+PROGMEM\s*=\s*\{(.*?)\};", re.S)
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def parse_font(path):
+    text = strip_comments(open(path, encoding="utf-8").read())
+    bitmap = [int(v, 0) for v in RE_BITMAPS.search(text).group(1).split(",") if v.strip()]
+    glyphs = [tuple(map(int, m.groups())) for m in RE_GLYPH.finditer(RE_GLYPHS.search(text).group(1))]
+    return RE_FONT.search(text).group(1), bitmap, glyphs
+
+
+def glyph_columns(bitmap, glyph):
+    off, w, h = glyph[0], glyph[1], glyph[2]
+    pages = (h + 7) // 8
+    out = [0] * (pages * w)
+    bit = 0
+    for yy in range(h):
+        for xx in range(w):
+            if bitmap[off + bit // 8] & (0x80 >> (bit % 8)):
+                out[(yy // 8) * w + xx] |= 1 << (yy % 8)
+            bit += 1
+    return out
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+
+    lines = ["// Сгенерировано font-atlas.py, не редактировать", ""]
+    table = []
+    for path in sys.argv[2:]:
+        name, bitmap, glyphs = parse_font(path)
+        data, offsets = [], []
+        for g in glyphs:
+            offsets.append(len(data))
+            data += glyph_columns(bitmap, g)
+
+        lines.append("static const uint8_t %s_Atlas[] = {" % name)
+        for i in range(0, len(data), 12):
+            lines.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 12]) + ",")
+        lines.append("};")
+        lines.append("static const uint16_t %s_AtlasOffset[] = {" % name)
+        for i in range(0, len(offsets), 12):
+            lines.append("    " + ", ".join(str(o) for o in offsets[i:i + 12]) + ",")
+        lines.append("};")
+        lines.append("")
+        table.append("    {&%s, %s_Atlas, %s_AtlasOffset}," % (name, name, name))
+
+    lines.append("static const GlyphAtlas glyphAtlases[] = {")
+    lines += table
+    lines.append("};")
+
+    with open(sys.argv[1], "w", encoding="utf-8") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -24,12 +24,14 @@ struct {
     batteryCalibration: 12;
 
   u8
-    reserved4 : 4,
+    micGain : 4,
     backlight : 4;
 
   u8 
     batsave : 4,
-    reserved3 : 4;
+    reserved3 : 1,
+    chSortCheck : 2,
+    debugApps : 1;
 
   u8 
     txTime : 4,
@@ -38,7 +40,8 @@ struct {
   u8
     roger : 3,
     iAmPro : 1,
-    micGain  : 4;
+    chSortOrder : 2,
+    fcTime : 2;
 
   u8
     keylock : 1,
@@ -360,12 +363,8 @@ class QuanshengUVK5Radio(chirp_common.CloneModeRadio):
         
         status.msg = f"Reading settings..."
         status.max = self.settings_size
-        while addr < status.max:
-            d = self.readmem(addr, self.BLOCK_SIZE)
-            data += d
-            addr += self.BLOCK_SIZE
-            status.cur = addr
-            self.status_fn(status)
+        data += self.read_range(addr, status.max, status)
+        addr = status.max
 
         self._mmap = memmap.MemoryMapBytes(data)
         self.process_mmap()
@@ -376,14 +375,15 @@ class QuanshengUVK5Radio(chirp_common.CloneModeRadio):
 
 
         status.max = self.settings_size + self.ch_size * self.ch_count
-        while addr < status.max:
-            d = self.readmem(addr, self.BLOCK_SIZE)
-            data += d
-            addr += self.BLOCK_SIZE
-            status.cur = addr
-            ch_num = addr * self.ch_count // status.max
+        # незавершённую сортировку из старого образа радио не продолжает
+        self._memobj.Settings.chSortOrder = 0
+        self._memobj.Settings.chSortCheck = 0
+
+        def channels_msg(cur):
+            ch_num = cur * self.ch_count // status.max
             status.msg = f"Reading channels {ch_num}/{self.ch_count}"
-            self.status_fn(status)
+
+        data += self.read_range(addr, status.max, status, channels_msg)
 
 
         self._mmap = memmap.MemoryMapBytes(data)
@@ -398,12 +398,19 @@ class QuanshengUVK5Radio(chirp_common.CloneModeRadio):
 
         # status.max = self.get_patch_address()
         status.max = self.settings_size + self.ch_size * self.ch_count
-        while addr < status.max:
-            self.writemem(self.get_mmap()[addr:addr + self.BLOCK_SIZE], addr)
-            status.cur = addr
-            addr += self.BLOCK_SIZE
-            status.msg = f"Uploading...{round(addr*100/status.max)}%"
-            self.status_fn(status)
+        if self.has_caps("c"):
+            self.write_changed(addr, status.max, status)
+        elif self.has_caps("b"):
+            def upload_msg(cur):
+                status.msg = f"Uploading...{round(cur*100/status.max)}%"
+            self.writemem_bulk(self.get_mmap()[addr:status.max], addr, status, upload_msg)
+        else:
+            while addr < status.max:
+                self.writemem(self.get_mmap()[addr:addr + self.BLOCK_SIZE], addr)
+                status.cur = addr
+                addr += self.BLOCK_SIZE
+                status.msg = f"Uploading...{round(addr*100/status.max)}%"
+                self.status_fn(status)
 
 
         if self.is_patch_can_be_sent():
@@ -826,6 +833,197 @@ class QuanshengUVK5Radio(chirp_common.CloneModeRadio):
         raise errors.RadioError("Failed to initialize radio{}".format(ERROR_TIP))
 
 
+    def has_caps(self, cap):
+        """Firmware lists protocol extensions after '+' in version string"""
+        version = self.FIRMWARE_VERSION or ""
+        return "+" in version and cap in version.split("+", 1)[1]
+
+
+    def read_range(self, addr, end, status, msg_fn=None):
+        """Read [addr, end) using bulk stream when firmware supports it"""
+        def progress(cur):
+            status.cur = cur
+            if msg_fn:
+                msg_fn(cur)
+            self.status_fn(status)
+
+        if self.has_caps("b"):
+            return self.readmem_bulk(addr, end - addr, progress)
+
+        data = b""
+        while addr < end:
+            data += self.readmem(addr, self.BLOCK_SIZE)
+            addr += self.BLOCK_SIZE
+            progress(addr)
+        return data[:len(data) - (addr - end)] if addr > end else data
+
+
+    def readmem_bulk(self, offset, n, progress=None):
+        cmd = pack("<HHII", 0x0530, 12, offset, n) + b"\x6a\x39\x57\x64"
+
+        for attempt in range(3):
+            try:
+                self._send_command(cmd)
+                data = b""
+                while True:
+                    o = self._receive_reply()
+                    rid = o[0] | (o[1] << 8)
+                    if rid == 0x0532:
+                        crc = o[12] | (o[13] << 8)
+                        if len(data) != n or crc != crc_hqx(data, 0):
+                            raise errors.RadioError("Bulk read CRC mismatch")
+                        return data
+                    if rid != 0x0531:
+                        raise errors.RadioError("Bad response to bulk read")
+                    data += o[12:12 + o[8]]
+                    if progress:
+                        progress(offset + len(data))
+            except Exception as e:
+                if attempt == 2:
+                    raise errors.RadioError(f"Failed to bulk read memory: {str(e)}{ERROR_TIP}")
+                self._drain()
+
+
+    def writemem_bulk(self, data, addr, status=None, msg_fn=None):
+        chunk = 64
+        n = len(data)
+        begin = pack("<HHII", 0x0533, 12, addr, n) + b"\x6a\x39\x57\x64"
+
+        self._send_command(begin)
+        o = self._receive_reply()
+        if o[0] != 0x34 or o[1] != 0x05:
+            raise errors.RadioError("Bad response to bulk write{}".format(ERROR_TIP))
+        window = max(1, o[8])
+
+        def send_frame(pos):
+            part = data[pos:pos + chunk]
+            frame = pack("<HHIB3x", 0x0535, 8 + len(part), addr + pos, len(part)) + part
+            self._send_command(frame)
+            return pos + len(part)
+
+        acked = 0
+        sent = 0
+        in_flight = 0
+        retries = 0
+        lost = 0
+        while acked < n:
+            # Держим до window кадров в полёте, подтверждения кумулятивные
+            while in_flight < window and sent < n:
+                sent = send_frame(sent)
+                in_flight += 1
+
+            try:
+                o = self._receive_reply()
+            except errors.RadioError:
+                # Ответ потерян: сбрасываем хвост линии и повторяем кадр с
+                # подтверждённого offset, радио ответит своим текущим
+                lost += 1
+                if lost > 5:
+                    raise
+                self._drain()
+                sent = send_frame(acked)
+                in_flight = 1
+                continue
+
+            if o[0] != 0x36 or o[1] != 0x05:
+                raise errors.RadioError("Bad response to bulk write{}".format(ERROR_TIP))
+            in_flight -= 1
+            acked = (o[4] | (o[5] << 8) | (o[6] << 16) | (o[7] << 24)) - addr
+
+            if o[9]:
+                raise errors.RadioError("Radio is locked, password area write denied{}".format(ERROR_TIP))
+
+            if not o[8]:
+                # Кадр потерян: радио отбрасывает кадры после него, и ответов
+                # на них может не быть - сбрасываем линию, а не ждём их
+                retries += 1
+                if retries > 10:
+                    raise errors.RadioError("Too many bulk write retries{}".format(ERROR_TIP))
+                self._drain()
+                in_flight = 0
+                sent = acked
+
+            if status:
+                status.cur = addr + acked
+                if msg_fn:
+                    msg_fn(addr + acked)
+                self.status_fn(status)
+
+        end = pack("<HHIIH2x", 0x0537, 16, addr, n, crc_hqx(bytes(data), 0)) + b"\x6a\x39\x57\x64"
+        self._send_command(end)
+        o = self._receive_reply()
+        if o[0] != 0x38 or o[1] != 0x05 or not o[6]:
+            raise errors.RadioError("Bulk write verify failed{}".format(ERROR_TIP))
+        return True
+
+
+    def read_block_crcs(self, offset, block_size, count):
+        """CRC16 digests of count EEPROM blocks, up to 64 per request"""
+        crcs = []
+        while len(crcs) < count:
+            n = min(64, count - len(crcs))
+            cmd = pack("<HHIHH", 0x0539, 12, offset + len(crcs) * block_size, block_size, n) + b"\x6a\x39\x57\x64"
+            self._send_command(cmd)
+            o = self._receive_reply()
+            if o[0] != 0x3a or o[1] != 0x05:
+                raise errors.RadioError("Bad response to block CRC{}".format(ERROR_TIP))
+            size = o[8] | (o[9] << 8)
+            got = o[10] | (o[11] << 8)
+            if not got or size != block_size:
+                raise errors.RadioError("Block CRC request out of range{}".format(ERROR_TIP))
+            crcs += [o[12 + i * 2] | (o[13 + i * 2] << 8) for i in range(got)]
+        return crcs
+
+
+    def write_changed(self, addr, end, status):
+        """Upload only blocks whose CRC differs from radio contents"""
+        block = 64
+        image = self.get_mmap()
+        count = (end - addr + block - 1) // block
+
+        status.msg = "Comparing..."
+        self.status_fn(status)
+        remote = self.read_block_crcs(addr, block, count)
+
+        runs = []
+        for i, crc in enumerate(remote):
+            start = addr + i * block
+            stop = min(start + block, end)
+            if crc_hqx(bytes(image[start:start + block]), 0) == crc and stop - start == block:
+                continue
+            if runs and runs[-1][1] == start:
+                runs[-1][1] = stop
+            else:
+                runs.append([start, stop])
+
+        total = sum(b - a for a, b in runs)
+        print(f"Delta upload: {total} of {end - addr} bytes in {len(runs)} runs")
+
+        done = 0
+        for start, stop in runs:
+            def upload_msg(cur, base=done, start=start):
+                status.msg = f"Uploading changes...{round((base + cur - start)*100/max(total, 1))}%"
+            if self.has_caps("b"):
+                self.writemem_bulk(image[start:stop], start, status, upload_msg)
+            else:
+                a = start
+                while a < stop:
+                    self.writemem(image[a:min(a + self.BLOCK_SIZE, stop)], a)
+                    a += self.BLOCK_SIZE
+                    upload_msg(min(a, stop))
+                    self.status_fn(status)
+            done += stop - start
+
+
+    def _drain(self):
+        time.sleep(0.5)
+        try:
+            while self.pipe.read(256):
+                pass
+        except Exception:
+            pass
+
+
     def readmem(self, offset, n):
         readmem = b"\x1b\x05\x0A\x00" + pack("<IBBBB", offset, n, 0, 0, 0) + b"\x6a\x39\x57\x64"
         
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Record binary spectrum stream (frame 0x0540) from hawk5 scanner.
+
+Usage: spectrum.py /dev/ttyUSB0 [--full] [--out survey.csv]
+       spectrum.py /dev/ttyUSB0 --sweep 144 146 12.5 [--dwell 1200] [--avg 2]
+       spectrum.py /dev/ttyUSB0 --reg 0x43 [--reg 0x43=0x3028]
+
+Each frame covers up to 32 sweep steps:
+  u16 seq, u8 flags, u8 count, u32 startF (10 Hz), u32 step (10 Hz),
+  u8 rssi[count] (dBm = q - 160), [u8 noise[count], u8 glitch[count]]
+"""
+import argparse
+import csv
+import sys
+import time
+from binascii import crc_hqx
+from itertools import cycle
+from struct import pack, unpack_from
+
+import serial
+
+KEY_COMM = [22, 108, 20, 230, 46, 145, 13, 64, 33, 53, 213, 64, 19, 3, 233, 128]
+
+STREAM_OFF, STREAM_RSSI, STREAM_FULL = 0, 1, 2
+FLAG_FULL = 1
+# Session stamp: sweep and register commands are accepted only with it
+TIMESTAMP = 0x6457396A
+
+
+def xor(data):
+    return bytes(a ^ b for a, b in zip(data, cycle(KEY_COMM)))
+
+
+def send_command(port, data):
+    data2 = data + pack("<H", crc_hqx(data, 0))
+    port.write(pack(">HBB", 0xabcd, len(data), 0) + xor(data2) + pack(">H", 0xdcba))
+
+
+def read_frame(port):
+    """Next reply frame payload (deobfuscated), resyncs on garbage"""
+    while True:
+        b = port.read(1)
+        if not b:
+            return None
+        if b[0] != 0xAB or port.read(1) != b"\xcd":
+            continue
+        size = int.from_bytes(port.read(2), "little")
+        body = port.read(size)
+        footer = port.read(4)
+        if len(body) != size or len(footer) != 4 or footer[2:] != b"\xdc\xba":
+            continue
+        return xor(body)
+
+
+def decode(payload):
+    seq, flags, count, start_f, step = unpack_from("<HBBII", payload, 4)
+    data = payload[16:]
+    rssi = data[:count]
+    if flags & FLAG_FULL:
+        noise = data[count:count * 2]
+        glitch = data[count * 2:count * 3]
+    else:
+        noise = glitch = [None] * count
+    return seq, start_f, step, rssi, noise, glitch
+
+
+def set_mode(port, mode):
+    send_command(port, pack("<HHB3x", 0x0541, 4, mode))
+
+
+def wait_reply(port, rid):
+    while True:
+        payload = read_frame(port)
+        if payload is None:
+            raise TimeoutError(f"no reply 0x{rid:04x}")
+        if unpack_from("<H", payload)[0] == rid:
+            return payload
+
+
+def hello(port):
+    """Open a session (0x0514): later commands carry the same timestamp"""
+    send_command(port, pack("<HHI", 0x0514, 4, TIMESTAMP))
+    wait_reply(port, 0x0515)
+
+
+def sweep(port, start_f, end_f, step, dwell_us=1200, avg=1):
+    """Remote sweep (0x0543), frequencies in 10 Hz units. Returns RSSI list"""
+    send_command(port, pack("<HHIIIHBxI", 0x0543, 20, start_f, end_f, step, dwell_us, avg, TIMESTAMP))
+    rssi = []
+    while True:
+        payload = read_frame(port)
+        if payload is None:
+            raise TimeoutError("sweep timed out")
+        rid = unpack_from("<H", payload)[0]
+        if rid == 0x0544:
+            index, count = unpack_from("<HB", payload, 4)
+            rssi[index:] = unpack_from(f"<{count}H", payload, 8)
+        elif rid == 0x0545:
+            count, time_ms, ok = unpack_from("<IIB", payload, 4)
+            if not ok:
+                raise ValueError("sweep rejected: range, points or time over limit")
+            return rssi[:count], time_ms
+
+
+def reg_read(port, reg):
+    send_command(port, pack("<HHB3xI", 0x0601, 8, reg, TIMESTAMP))
+    return unpack_from("<H", wait_reply(port, 0x0602), 4)[0]
+
+
+def reg_write(port, reg, value):
+    send_command(port, pack("<HHBxHI", 0x0602, 8, reg, value, TIMESTAMP))
+    return unpack_from("<H", wait_reply(port, 0x0603), 4)[0]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("port")
+    ap.add_argument("--baud", type=int, default=38400)
+    ap.add_argument("--full", action="store_true", help="include noise and glitch (two extra register reads per step)")
+    ap.add_argument("--out", help="CSV file, stdout summary only if omitted")
+    ap.add_argument("--sweep", nargs=3, type=float, metavar=("START_MHZ", "END_MHZ", "STEP_KHZ"),
+                    help="one-shot remote sweep instead of stream")
+    ap.add_argument("--dwell", type=int, default=1200, help="sweep dwell, us")
+    ap.add_argument("--avg", type=int, default=1, help="sweep averaging")
+    ap.add_argument("--reg", action="append", help="BK4819 register: REG or REG=VALUE")
+    args = ap.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=1)
+
+    if args.reg or args.sweep:
+        hello(port)
+
+    if args.reg:
+        for r in args.reg:
+            reg, _, value = r.partition("=")
+            reg = int(reg, 0)
+            v = reg_write(port, reg, int(value, 0)) if value else reg_read(port, reg)
+            print(f"REG_{reg:02X} = 0x{v:04X}")
+        return
+
+    if args.sweep:
+        start_f = round(args.sweep[0] * 1e5)
+        end_f = round(args.sweep[1] * 1e5)
+        step = round(args.sweep[2] * 100)
+        port.timeout = 5
+        rssi, time_ms = sweep(port, start_f, end_f, step, args.dwell, args.avg)
+        sys.stderr.write(f"{len(rssi)} points in {time_ms} ms\n")
+        w = csv.writer(open(args.out, "w", newline="") if args.out else sys.stdout)
+        w.writerow(["f_hz", "dbm"])
+        for i, r in enumerate(rssi):
+            w.writerow([(start_f + i * step) * 10, r / 2 - 160])
+        return
+    set_mode(port, STREAM_FULL if args.full else STREAM_RSSI)
+
+    out = None
+    if args.out:
+        f = open(args.out, "w", newline="")
+        out = csv.writer(f)
+        out.writerow(["time", "seq", "f_hz", "dbm", "noise", "glitch"])
+
+    last_seq = None
+    frames = lost = 0
+    try:
+        while True:
+            payload = read_frame(port)
+            if payload is None or len(payload) < 16:
+                continue
+            if unpack_from("<H", payload)[0] != 0x0540:
+                continue
+
+            seq, start_f, step, rssi, noise, glitch = decode(payload)
+            if last_seq is not None:
+                lost += (seq - last_seq - 1) & 0xFFFF
+            last_seq = seq
+            frames += 1
+
+            now = time.time()
+            if out:
+                for i, q in enumerate(rssi):
+                    out.writerow([f"{now:.3f}", seq, (start_f + i * step) * 10,
+                                  q - 160, noise[i], glitch[i]])
+            peak = max(range(len(rssi)), key=lambda i: rssi[i])
+            sys.stderr.write(
+                f"\r#{seq:5} {start_f / 1e5:10.5f} MHz +{len(rssi):2}x{step / 100:g} kHz"
+                f" peak {(start_f + peak * step) / 1e5:.5f} {rssi[peak] - 160} dBm"
+                f" lost {lost}/{frames + lost}   ")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        set_mode(port, STREAM_OFF)
+        if out:
+            f.close()
+        sys.stderr.write("\n")
+
+
+if __name__ == "__main__":
+    main()
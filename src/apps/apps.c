@@ -6,6 +6,7 @@
 #include "../ui/statusline.h"
 #include "about.h"
 #include "appslist.h"
+#include "bench.h"
 #include "bandscan.h"
 #include "chcfg.h"
 #include "chlist.h"
@@ -13,6 +14,7 @@
 #include "fc.h"
 #include "finput.h"
 #include "lootlist.h"
+#include "perf.h"
 #include "reset.h"
 #include "scaner.h"
 #include "settings.h"
@@ -62,28 +64,36 @@ const AppType_t appsAvailableToRun[RUN_APPS_COUNT] = {
     APP_CH_SCAN,   //
     APP_BAND_SCAN, //
     APP_ABOUT,     //
+    APP_PERF,      //
+    APP_BENCH,     //
 };
 
+uint8_t APPS_GetRunCount(void) {
+  return RUN_APPS_COUNT - (gSettings.debugApps ? 0 : DEBUG_APPS_COUNT);
+}
+
 const App apps[APPS_COUNT] = {
     [APP_NONE] = {"None", NULL, NULL, NULL, NULL, NULL},
     [APP_FINPUT] = {"Freq input", FINPUT_init, FINPUT_update, FINPUT_render,
                     FINPUT_key, FINPUT_deinit},
     [APP_TEXTINPUT] = {"Text input", TEXTINPUT_init, NULL, TEXTINPUT_render,
                        TEXTINPUT_key, TEXTINPUT_deinit},
-    [APP_SETTINGS] = {"Settings", SETTINGS_init, NULL, SETTINGS_render,
-                      SETTINGS_key, SETTINGS_deinit},
-    [APP_APPS_LIST] = {"Run app", APPSLIST_init, NULL, APPSLIST_render,
-                       APPSLIST_key, NULL},
+    [APP_SETTINGS] = {"Settings", SETTINGS_init, NULL, NULL, SETTINGS_key,
+                      SETTINGS_deinit, false, MENU_WIDGETS, MENU_WIDGETS_COUNT},
+    [APP_APPS_LIST] = {"Run app", APPSLIST_init, NULL, NULL, APPSLIST_key,
+                       NULL, false, MENU_WIDGETS, MENU_WIDGETS_COUNT},
     [APP_RESET] = {"Reset", RESET_Init, RESET_Update, RESET_Render, RESET_key,
                    NULL},
-    [APP_CH_CFG] = {"CH cfg", CHCFG_init, NULL, CHCFG_render, CHCFG_key,
-                    CHCFG_deinit},
+    [APP_CH_CFG] = {"CH cfg", CHCFG_init, NULL, NULL, CHCFG_key, CHCFG_deinit,
+                    false, MENU_WIDGETS, MENU_WIDGETS_COUNT},
     [APP_CH_LIST] = {"Channels", CHLIST_init, NULL, CHLIST_render, CHLIST_key,
                      CHLIST_deinit},
-    [APP_SCANER] = {"Spectrum", SCANER_init, SCANER_update, SCANER_render,
-                    SCANER_key, SCANER_deinit, true},
-    [APP_LOOT_LIST] = {"Loot", LOOTLIST_init, LOOTLIST_update, LOOTLIST_render,
-                       LOOTLIST_key, NULL},
+    [APP_SCANER] = {"Spectrum", SCANER_init, SCANER_update, NULL, SCANER_key,
+                    SCANER_deinit, true, SCANER_WIDGETS,
+                    SCANER_WIDGETS_COUNT},
+    [APP_LOOT_LIST] = {"Loot", LOOTLIST_init, LOOTLIST_update, NULL,
+                       LOOTLIST_key, NULL, false, MENU_WIDGETS,
+                       MENU_WIDGETS_COUNT},
     [APP_CH_SCAN] = {"CH Scan", CHSCAN_init, CHSCAN_update, CHSCAN_render,
                      CHSCAN_key, CHSCAN_deinit, true},
     [APP_BAND_SCAN] = {"Band Scan", BANDSCAN_init, BANDSCAN_update,
@@ -94,6 +104,10 @@ const App apps[APPS_COUNT] = {
     /* [APP_GENERATOR] = {"Generator", GENERATOR_init, GENERATOR_update,
                        GENERATOR_render, GENERATOR_key, NULL, true, true}, */
     [APP_ABOUT] = {"ABOUT", NULL, NULL, ABOUT_Render, NULL, NULL},
+    [APP_PERF] = {"Loop perf", PERF_init, PERF_update, PERF_render, PERF_key,
+                  NULL},
+    [APP_BENCH] = {"Benchmark", BENCH_init, NULL, BENCH_render, BENCH_key, NULL,
+                   true},
 };
 
 bool APPS_key(KEY_Code_t Key, Key_State_t state) {
@@ -121,10 +135,21 @@ void APPS_update(void) {
 }
 
 void APPS_render(void) {
-  if (apps[gCurrentApp].render) {
+  const App *app = &apps[gCurrentApp];
+  if (app->render || app->widgetsCount) {
     UI_ClearScreen();
-    apps[gCurrentApp].render();
   }
+  if (app->render) {
+    app->render();
+  }
+  for (uint8_t i = 0; i < app->widgetsCount; ++i) {
+    app->widgets[i].render();
+  }
+}
+
+bool APPS_renderDirty(uint8_t mask) {
+  const App *app = &apps[gCurrentApp];
+  return UI_RenderWidgets(app->widgets, app->widgetsCount, mask);
 }
 
 void APPS_deinit(void) {
@@ -3,8 +3,11 @@
 
 #include "../driver/keyboard.h"
 #include "../radio.h"
+#include "../ui/widgets.h"
 
-#define RUN_APPS_COUNT 7
+#define RUN_APPS_COUNT 9
+// Последние в appsAvailableToRun, видны только с gSettings.debugApps
+#define DEBUG_APPS_COUNT 2
 
 typedef enum {
   APP_NONE,
@@ -23,6 +26,8 @@ typedef enum {
   APP_VFO1,
   // APP_GENERATOR,
   APP_ABOUT,
+  APP_PERF,
+  APP_BENCH,
 
   APPS_COUNT,
 } AppType_t;
@@ -36,6 +41,8 @@ typedef struct App {
   void (*deinit)(void);
   bool needsRadioState;
   // RadioState radioState;
+  const Widget *widgets; // области для частичной перерисовки
+  uint8_t widgetsCount;
 } App;
 
 extern const App apps[APPS_COUNT];
@@ -44,10 +51,12 @@ extern const AppType_t appsAvailableToRun[RUN_APPS_COUNT];
 extern AppType_t gCurrentApp;
 
 AppType_t APPS_Peek();
+uint8_t APPS_GetRunCount(void);
 bool APPS_key(KEY_Code_t Key, Key_State_t state);
 void APPS_init(AppType_t app);
 void APPS_update(void);
 void APPS_render(void);
+bool APPS_renderDirty(uint8_t mask);
 void APPS_run(AppType_t app);
 void APPS_runManual(AppType_t app);
 bool APPS_exit(void);
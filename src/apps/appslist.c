@@ -22,7 +22,8 @@ static bool run(const MenuItem *item, KEY_Code_t key, Key_State_t state) {
 }
 
 void APPSLIST_init(void) {
-  for (uint8_t i = 0; i < RUN_APPS_COUNT; ++i) {
+  appsMenu.num_items = APPS_GetRunCount();
+  for (uint8_t i = 0; i < appsMenu.num_items; ++i) {
     AppType_t app = appsAvailableToRun[i];
     appsItems[i].name = apps[app].name;
     appsItems[i].action = run;
@@ -38,4 +39,3 @@ bool APPSLIST_key(KEY_Code_t key, Key_State_t state) {
   return false;
 }
 
-void APPSLIST_render(void) { MENU_Render(); }
@@ -0,0 +1,214 @@
+#include "bench.h"
+#include "../driver/bk4819-regs.h"
+#include "../driver/bk4819.h"
+#include "../driver/eeprom.h"
+#include "../driver/st7565.h"
+#include "../driver/systick.h"
+#include "../driver/uart.h"
+#include "../helper/bands.h"
+#include "../helper/channels.h"
+#include "../helper/scan.h"
+#include "../radio.h"
+#include "../settings.h"
+#include "../ui/graphics.h"
+#include "../ui/spectrum.h"
+#include "apps.h"
+#include <string.h>
+
+// Воспроизводимый отчёт о скорости шин и отрисовки на конкретном экземпляре.
+// 5 - запуск, результаты на экране и в UART
+
+typedef enum {
+  BENCH_REG_READ,
+  BENCH_REG_WRITE,
+  BENCH_EE_READ,
+  BENCH_EE_WRITE,
+  BENCH_BLIT_FULL,
+  BENCH_BLIT_PAGE,
+  BENCH_SP_RENDER,
+  BENCH_SP_RENDER_PX,
+  BENCH_MEASURE,
+  BENCH_NOISE_GLITCH,
+  BENCH_COUNT,
+} BenchItem;
+
+static const char *BENCH_NAMES[BENCH_COUNT] = {
+    [BENCH_REG_READ] = "BK reg rd",   [BENCH_REG_WRITE] = "BK reg wr",
+    [BENCH_EE_READ] = "EE read",      [BENCH_EE_WRITE] = "EE write",
+    [BENCH_BLIT_FULL] = "Blit full",  [BENCH_BLIT_PAGE] = "Blit page",
+    [BENCH_SP_RENDER] = "SP render",  [BENCH_SP_RENDER_PX] = "SP pixel",
+    [BENCH_MEASURE] = "Measure",
+    [BENCH_NOISE_GLITCH] = "Noise+glt",
+};
+
+static const char *BENCH_UNITS[BENCH_COUNT] = {
+    [BENCH_REG_READ] = "/s",  [BENCH_REG_WRITE] = "/s",
+    [BENCH_EE_READ] = "B/s",  [BENCH_EE_WRITE] = "B/s",
+    [BENCH_BLIT_FULL] = "us", [BENCH_BLIT_PAGE] = "us",
+    [BENCH_SP_RENDER] = "us", [BENCH_SP_RENDER_PX] = "us",
+    [BENCH_MEASURE] = "us",
+    [BENCH_NOISE_GLITCH] = "us",
+};
+
+static uint32_t results[BENCH_COUNT];
+static bool done;
+static bool eeWriteSkipped;
+
+#define REG_N 1000
+#define BLIT_N 10
+#define RENDER_N 10
+#define MEASURE_N 128
+#define EE_WRITE_PAGES 4
+
+static uint32_t perSecond(uint32_t n, uint32_t us) {
+  uint32_t ms = (us + 500) / 1000;
+  return ms ? n * 1000 / ms : 0;
+}
+
+static void benchRegisters(void) {
+  uint32_t t = GetUptimeUs();
+  for (uint16_t i = 0; i < REG_N; ++i) {
+    BK4819_ReadRegister(BK4819_REG_67);
+  }
+  results[BENCH_REG_READ] = perSecond(REG_N, GetUptimeUs() - t);
+
+  // Пишем то же значение маски прерываний - состояние чипа не меняется
+  uint16_t v = BK4819_ReadRegister(BK4819_REG_3F);
+  t = GetUptimeUs();
+  for (uint16_t i = 0; i < REG_N; ++i) {
+    BK4819_WriteRegister(BK4819_REG_3F, v);
+  }
+  results[BENCH_REG_WRITE] = perSecond(REG_N, GetUptimeUs() - t);
+}
+
+static void benchEeprom(void) {
+  results[BENCH_EE_READ] = EEPROM_TestReadSpeed(8192);
+
+  // Запись только в свободный хвост за таблицей каналов: сбой питания
+  // посреди теста не заденет настройки и калибровку. Нет хвоста - нет теста
+  const uint16_t pageSize = EEPROM_GetPageSize();
+  uint32_t start;
+  uint32_t spare = CHANNELS_GetSpareArea(&start);
+  uint32_t aligned = (start + pageSize - 1) / pageSize * pageSize;
+
+  eeWriteSkipped = spare < aligned - start + EE_WRITE_PAGES * pageSize;
+  results[BENCH_EE_WRITE] =
+      eeWriteSkipped ? 0 : EEPROM_TestWriteSpeed(aligned, EE_WRITE_PAGES);
+}
+
+static void benchBlit(void) {
+  uint32_t t = 0;
+
+  // Каждый кадр отличается от предыдущего во всех страницах
+  for (uint8_t i = 0; i < BLIT_N; ++i) {
+    memset(gFrameBuffer, (i & 1) ? 0x55 : 0xAA, sizeof(gFrameBuffer));
+    ST7565_Invalidate();
+    uint32_t s = GetUptimeUs();
+    ST7565_Blit();
+    t += GetUptimeUs() - s;
+  }
+  results[BENCH_BLIT_FULL] = t / BLIT_N;
+
+  t = 0;
+  for (uint8_t i = 0; i < BLIT_N; ++i) {
+    memset(gFrameBuffer[3], (i & 1) ? 0xAA : 0x55, LCD_WIDTH);
+    ST7565_MarkDirty(3, 0, LCD_WIDTH - 1);
+    uint32_t s = GetUptimeUs();
+    ST7565_Blit();
+    t += GetUptimeUs() - s;
+  }
+  results[BENCH_BLIT_PAGE] = t / BLIT_N;
+}
+
+static uint32_t renderTime(void) {
+  uint32_t t = GetUptimeUs();
+  for (uint8_t i = 0; i < RENDER_N; ++i) {
+    SP_Render(&gCurrentBand, SP_GetMinMax());
+  }
+  return (GetUptimeUs() - t) / RENDER_N;
+}
+
+// Спектр получает указатель на диапазон и хранит его, поэтому только
+// gCurrentBand; в конце прогон сбрасывается, чтобы не остался в сканере
+static void benchSpectrum(void) {
+  uint32_t step = StepFrequencyTable[gCurrentBand.step];
+  uint32_t f0 = RADIO_GetParam(ctx, PARAM_FREQUENCY);
+  uint32_t t;
+
+  // Сырой путь сканера: установка частоты + чтение RSSI, без выдержки
+  SP_Init(&gCurrentBand);
+  t = GetUptimeUs();
+  for (uint8_t i = 0; i < MEASURE_N; ++i) {
+    vfo->msm.f = gCurrentBand.rxF + i * step;
+    vfo->msm.rssi = SCAN_Measure(vfo->msm.f, 0);
+    SP_AddPoint(&vfo->msm);
+  }
+  results[BENCH_MEASURE] = (GetUptimeUs() - t) / MEASURE_N;
+
+  // Добавка потока STREAM_FULL к каждому шагу развёртки
+  t = GetUptimeUs();
+  for (uint8_t i = 0; i < MEASURE_N; ++i) {
+    BK4819_GetNoise();
+    BK4819_GetGlitch();
+  }
+  results[BENCH_NOISE_GLITCH] = (GetUptimeUs() - t) / MEASURE_N;
+
+  RADIO_SetParam(ctx, PARAM_FREQUENCY, f0, false);
+  RADIO_ApplySettings(ctx);
+
+  // Один и тот же кадр из замеров выше: страничный путь заливки и
+  // попиксельный, которым столбцы спектра шли раньше
+  results[BENCH_SP_RENDER] = renderTime();
+  gPixelFill = true;
+  results[BENCH_SP_RENDER_PX] = renderTime();
+  gPixelFill = false;
+
+  SP_Init(&gCurrentBand);
+}
+
+static void run(void) {
+  UI_ClearScreen();
+  PrintMediumEx(LCD_XCENTER, LCD_YCENTER, POS_C, C_FILL, "Benchmark...");
+  ST7565_Blit();
+
+  benchRegisters();
+  benchEeprom();
+  benchSpectrum();
+  benchBlit();
+
+  for (uint8_t i = 0; i < BENCH_COUNT; ++i) {
+    UART_printf("BENCH %-10s %10u %s\n", BENCH_NAMES[i], results[i],
+                BENCH_UNITS[i]);
+  }
+
+  done = true;
+  gRedrawScreen = true;
+}
+
+void BENCH_init() { gRedrawScreen = true; }
+
+bool BENCH_key(KEY_Code_t key, Key_State_t state) {
+  if (state == KEY_RELEASED && key == KEY_5) {
+    run();
+    return true;
+  }
+  return false;
+}
+
+void BENCH_render() {
+  if (!done) {
+    PrintMediumEx(LCD_XCENTER, LCD_YCENTER, POS_C, C_FILL, "5 - run");
+    return;
+  }
+
+  for (uint8_t i = 0; i < BENCH_COUNT; ++i) {
+    uint8_t y = 12 + i * 5;
+    PrintSmall(0, y, BENCH_NAMES[i]);
+    if (i == BENCH_EE_WRITE && eeWriteSkipped) {
+      PrintSmallEx(LCD_WIDTH - 12, y, POS_R, C_FILL, "no spare");
+      continue;
+    }
+    PrintSmallEx(LCD_WIDTH - 12, y, POS_R, C_FILL, "%u", results[i]);
+    PrintSmall(LCD_WIDTH - 11, y, BENCH_UNITS[i]);
+  }
+}
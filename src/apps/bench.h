@@ -0,0 +1,12 @@
+#ifndef BENCH_APP_H
+#define BENCH_APP_H
+
+#include "../driver/keyboard.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+void BENCH_init();
+bool BENCH_key(KEY_Code_t key, Key_State_t state);
+void BENCH_render();
+
+#endif /* end of include guard: BENCH_APP_H */
@@ -623,4 +623,3 @@ bool CHCFG_key(KEY_Code_t key, Key_State_t state) {
   return MENU_HandleInput(key, state);
 }
 
-void CHCFG_render(void) { MENU_Render(); }
@@ -9,7 +9,6 @@
 void CHCFG_init();
 void CHCFG_deinit();
 bool CHCFG_key(KEY_Code_t key, Key_State_t state);
-void CHCFG_render();
 
 extern CH gChEd;
 extern int16_t gChNum;
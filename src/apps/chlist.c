@@ -1,4 +1,5 @@
 #include "chlist.h"
+#include "../driver/systick.h"
 #include "../driver/uart.h"
 #include "../helper/bands.h"
 #include "../helper/menu.h"
@@ -64,7 +65,7 @@ static inline uint16_t getChannelNumber(uint16_t menuIndex) {
     Log("ERROR: menuIndex %u >= gScanlistSize %u", menuIndex, gScanlistSize);
     return 0; // или другое безопасное значение
   }
-  return gScanlist[menuIndex];
+  return CHANNELS_ScanlistAt(menuIndex);
 }
 
 static void renderItem(uint16_t index, uint8_t i) {
@@ -211,10 +212,18 @@ void CHLIST_init() {
   Log("Scanlist loaded: size=%u", gScanlistSize);
 
   /* for (uint16_t i = 0; i < gScanlistSize; i++) {
-    Log("gScanlist[%u] = %u", i, gScanlist[i]);
+    Log("SL[%u] = %u", i, CHANNELS_ScanlistAt(i));
   } */
 
   chListMenu.num_items = gScanlistSize;
+  if (gChSaveMode) {
+    // курсор на первый свободный слот
+    int16_t freeCh = CHANNELS_FindFree(0, true);
+    int16_t i = freeCh >= 0 ? CHANNELS_ScanlistIndexOf(freeCh) : -1;
+    if (i >= 0) {
+      chListMenu.i = i;
+    }
+  }
   MENU_Init(&chListMenu);
   // TODO: set menu index
   /* if (gChListFilter == TYPE_FILTER_BAND ||
@@ -230,6 +239,21 @@ void CHLIST_init() {
 
 void CHLIST_deinit() { gChSaveMode = false; }
 
+static void sortChannels(CHSortOrder order) {
+  FillRect(0, LCD_YCENTER - 4, LCD_WIDTH, 9, C_FILL);
+  PrintMediumBoldEx(LCD_XCENTER, LCD_YCENTER + 3, POS_C, C_INVERT,
+                    "Sorting...");
+  ST7565_Blit();
+  if (!CHANNELS_Sort(order)) {
+    FillRect(0, LCD_YCENTER - 4, LCD_WIDTH, 9, C_FILL);
+    PrintMediumBoldEx(LCD_XCENTER, LCD_YCENTER + 3, POS_C, C_INVERT,
+                      "Need 2 free");
+    ST7565_Blit();
+    TIMER_DelayMs(1000);
+  }
+  CHLIST_init();
+}
+
 bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
   if (state == KEY_LONG_PRESSED) {
     switch (key) {
@@ -239,6 +263,12 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
       CHANNELS_LoadScanlist(TYPE_FILTER_CH, gSettings.currentScanlist);
       CHLIST_init();
       break;
+    case KEY_STAR:
+      sortChannels(CH_SORT_F);
+      return true;
+    case KEY_9:
+      sortChannels(CH_SORT_NAME);
+      return true;
     default:
       break;
     }
@@ -288,6 +318,8 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
 
 void CHLIST_render() {
   MENU_Render();
-  STATUSLINE_SetText("%s %s", CH_TYPE_FILTER_NAMES[gChListFilter],
-                     VIEW_MODE_NAMES[viewMode]);
+  // не все каналы попали в индекс по частоте: имена находятся не для всех
+  STATUSLINE_SetText("%s %s%s", CH_TYPE_FILTER_NAMES[gChListFilter],
+                     VIEW_MODE_NAMES[viewMode],
+                     CHANNELS_FIndexComplete() ? "" : " F!");
 }
@@ -70,6 +70,10 @@ static void getLootItem(uint16_t i, uint16_t index) {
 
   // PrintSmallEx(8, y + 7 + 6, POS_L, C_INVERT, "%03ddB",
   // Rssi2DBm(item->rssi));
+  char name[11];
+  if (CHANNELS_GetNameByF(item->f, name)) {
+    PrintSmallEx(8, y + 7 + 6, POS_L, C_INVERT, "%s", name);
+  }
   if (item->ct != 0xFF) {
     PrintSmallEx(8 + 55, y + 7 + 6, POS_L, C_INVERT, "CT:%u.%uHz",
                  CTCSS_Options[item->ct] / 10, CTCSS_Options[item->ct] % 10);
@@ -124,9 +128,31 @@ static void saveToFreeChannels(bool saveWhitelist, uint16_t scanlist) {
   FillRect(0, LCD_YCENTER - 4, LCD_WIDTH, 9, C_FILL);
   PrintMediumBoldEx(LCD_XCENTER, LCD_YCENTER + 3, POS_C, C_INVERT, "Saving...");
   ST7565_Blit();
+
+  // частоты, уже сохранённые в каналах; если индекс по частоте неполный,
+  // отмечаем их за один проход по EEPROM
+  const bool fIndexComplete = CHANNELS_FIndexComplete();
+  uint8_t exists[(LOOT_SIZE_MAX + 7) / 8] = {0};
+  for (uint16_t chnum = 0; !fIndexComplete && chnum < CHANNELS_GetCountMax();
+       ++chnum) {
+    if (CHANNELS_IsFree(chnum)) {
+      continue;
+    }
+    CH ch;
+    CHANNELS_Load(chnum, &ch);
+    if (ch.meta.type != TYPE_CH) {
+      continue;
+    }
+    for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+      if (LOOT_Item(i)->f == ch.rxF) {
+        exists[i >> 3] |= 1 << (i & 7);
+      }
+    }
+  }
+
   uint32_t saved = 0;
+  int16_t chnum = CHANNELS_GetCountMax() - 1;
   for (uint16_t i = 0; i < LOOT_Size(); ++i) {
-    uint16_t chnum = CHANNELS_GetCountMax();
     const Loot *loot = LOOT_Item(i);
     if (saveWhitelist && !loot->whitelist) {
       continue;
@@ -134,22 +160,17 @@ static void saveToFreeChannels(bool saveWhitelist, uint16_t scanlist) {
     if (!saveWhitelist && !loot->blacklist) {
       continue;
     }
+    if (fIndexComplete ? CHANNELS_FindByF(loot->f) >= 0
+                       : (exists[i >> 3] & (1 << (i & 7)))) {
+      continue;
+    }
 
-    while (chnum) {
-      chnum--;
-      if (CHANNELS_GetMeta(chnum).type == TYPE_EMPTY) {
-        // save new
-        saveLootToCh(loot, chnum, scanlist);
-        saved++;
-        break;
-      } else {
-        CH ch;
-        CHANNELS_Load(chnum, &ch);
-        if (ch.rxF == loot->f && ch.meta.type == TYPE_CH) {
-          break;
-        }
-      }
+    chnum = CHANNELS_FindFree(chnum, false);
+    if (chnum < 0) {
+      break;
     }
+    saveLootToCh(loot, chnum, scanlist);
+    saved++;
   }
 
   FillRect(0, LCD_YCENTER - 4, LCD_WIDTH, 9, C_FILL);
@@ -279,8 +300,6 @@ static void initMenu() {
   MENU_Init(&lootMenu);
 }
 
-void LOOTLIST_render(void) { MENU_Render(); }
-
 void LOOTLIST_init(void) {
   SCAN_SetMode(SCAN_MODE_SINGLE);
   // SCAN_Init(false);
@@ -8,6 +8,5 @@
 void LOOTLIST_init();
 void LOOTLIST_update();
 bool LOOTLIST_key(KEY_Code_t key, Key_State_t state);
-void LOOTLIST_render();
 
 #endif /* end of include guard: LOOTLIST_APP_H */
@@ -0,0 +1,63 @@
+#include "perf.h"
+#include "../helper/profile.h"
+#include "../scheduler.h"
+#include "../ui/graphics.h"
+#include "apps.h"
+
+// Гистограммы задержек этапов главного цикла:
+// этап | медиана (верх корзины) | худший случай | форма распределения.
+// 0 - сброс статистики
+
+static const uint8_t ROW_Y = 10;
+static const uint8_t ROW_H = 6;
+static const uint8_t HIST_X = 80;
+static const uint8_t BAR_W = 3;
+
+static uint32_t lastRender;
+
+void PERF_init() { gRedrawScreen = true; }
+
+void PERF_update() {
+  if (Now() - lastRender >= 250) {
+    gRedrawScreen = true;
+  }
+}
+
+bool PERF_key(KEY_Code_t key, Key_State_t state) {
+  if (state == KEY_RELEASED && key == KEY_0) {
+    PROF_Reset();
+    gRedrawScreen = true;
+    return true;
+  }
+  return false;
+}
+
+void PERF_render() {
+  for (uint8_t i = 0; i < PROF_COUNT; ++i) {
+    const ProfStat *s = PROF_Get(i);
+    uint8_t y = ROW_Y + i * ROW_H;
+    uint8_t peak = 1;
+
+    PrintSmall(0, y + 5, PROF_NAMES[i]);
+    if (!s->count) {
+      continue;
+    }
+    PrintSmallEx(44, y + 5, POS_R, C_FILL, "<%u",
+                 PROF_BucketUs(PROF_Median(i)));
+    PrintSmallEx(76, y + 5, POS_R, C_FILL, "%u", s->max);
+
+    for (uint8_t b = 0; b < PROF_BUCKETS; ++b) {
+      if (s->hist[b] > peak) {
+        peak = s->hist[b];
+      }
+    }
+    for (uint8_t b = 0; b < PROF_BUCKETS; ++b) {
+      uint8_t h = (s->hist[b] * (ROW_H - 1) + peak - 1) / peak;
+      if (h) {
+        FillRect(HIST_X + b * BAR_W, y + ROW_H - 1 - h, BAR_W - 1, h, C_FILL);
+      }
+    }
+  }
+
+  lastRender = Now();
+}
@@ -0,0 +1,13 @@
+#ifndef PERF_APP_H
+#define PERF_APP_H
+
+#include "../driver/keyboard.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+void PERF_init();
+void PERF_update();
+bool PERF_key(KEY_Code_t key, Key_State_t state);
+void PERF_render();
+
+#endif /* end of include guard: PERF_APP_H */
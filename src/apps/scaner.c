@@ -4,6 +4,7 @@
 #include "../helper/bands.h"
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
+#include "../helper/menu.h"
 #include "../helper/regs-menu.h"
 #include "../helper/scan.h"
 #include "../radio.h"
@@ -11,6 +12,7 @@
 #include "../ui/components.h"
 #include "../ui/spectrum.h"
 #include "../ui/statusline.h"
+#include "../ui/waterfall.h"
 #include "apps.h"
 #include "chlist.h"
 #include "finput.h"
@@ -46,10 +48,24 @@ static void initBand(void) {
   } */
 }
 
+// Водопад занимает страницы 4-6, спектр над ним ужимается
+#define WF_PAGE 4
+#define SCANER_WIDGET_SPECTRUM 1
+
+static bool showWaterfall;
+
+static void applyLayout(void) {
+  SPECTRUM_Y = 8;
+  SPECTRUM_H = WF_IsEnabled() ? WF_PAGE * 8 - SPECTRUM_Y - 4 : 44;
+  // область спектра не должна стирать водопад
+  SCANER_WIDGETS[SCANER_WIDGET_SPECTRUM].h =
+      (WF_IsEnabled() ? WF_PAGE * 8 : LCD_HEIGHT - 8) - 7;
+}
+
 void SCANER_init(void) {
   gMonitorMode = false;
-  SPECTRUM_Y = 8;
-  SPECTRUM_H = 44;
+  WF_SetEnabled(showWaterfall);
+  applyLayout();
 
   initBand();
 
@@ -80,6 +96,21 @@ static bool handleLongPress(KEY_Code_t key) {
     CUR_Reset();
     return true;
 
+  case KEY_4:
+    SP_SetTrace((SP_GetTrace() + 1) % SP_TRACE_COUNT, SP_GetTraceOverlay());
+    gRedrawScreen = true;
+    return true;
+
+  case KEY_5:
+    SP_SetTrace(SP_GetTrace(), !SP_GetTraceOverlay());
+    gRedrawScreen = true;
+    return true;
+
+  case KEY_STAR:
+    SP_SetBin((SP_GetBin() + 1) % SP_BIN_COUNT);
+    gRedrawScreen = true;
+    return true;
+
   case KEY_0:
     gChListFilter = TYPE_FILTER_BAND;
     APPS_run(APP_CH_LIST);
@@ -164,6 +195,13 @@ static bool handlePTTRelease(void) {
   return false;
 }
 
+static void toggleWaterfall(void) {
+  showWaterfall = !showWaterfall;
+  WF_SetEnabled(showWaterfall);
+  applyLayout();
+  SP_Init(&gCurrentBand);
+}
+
 static bool handleRelease(KEY_Code_t key) {
   uint32_t step = StepFrequencyTable[RADIO_GetParam(ctx, PARAM_STEP)];
 
@@ -172,6 +210,10 @@ static bool handleRelease(KEY_Code_t key) {
     toggleAnalyserMode();
     return true;
 
+  case KEY_6:
+    toggleWaterfall();
+    return true;
+
   case KEY_5:
     gFInputCallback = setRange;
     FINPUT_setup(0, BK4819_F_MAX, UNIT_MHZ, true);
@@ -248,12 +290,41 @@ static void renderAnalyzerUI(void) {
                Rssi2DBm(mm.vMin));
 }
 
-static void renderTopInfo(void) {
-  const uint32_t step = StepFrequencyTable[RADIO_GetParam(ctx, PARAM_STEP)];
+// Строка находки выводится инверсией поверх спектра, поэтому стирается
+// повторным выводом того, что было нарисовано, без перерисовки спектра
+static Loot lootShown;
+static bool lootShownValid;
 
-  if (gLastActiveLoot) {
-    UI_DrawLoot(gLastActiveLoot, LCD_XCENTER, 14, POS_C);
+static void drawLootShown(void) {
+  UI_DrawLoot(&lootShown, LCD_XCENTER, 14, POS_C);
+}
+
+static void renderLoot(void) {
+  const Loot *l = gLastActiveLoot;
+  if (lootShownValid && l && l->f == lootShown.f &&
+      l->open == lootShown.open && l->blacklist == lootShown.blacklist &&
+      l->whitelist == lootShown.whitelist) {
+    return;
+  }
+  if (lootShownValid) {
+    drawLootShown();
   }
+  lootShownValid = l != NULL;
+  if (l) {
+    lootShown = *l;
+    drawLootShown();
+  }
+}
+
+// Меню регистров лежит поверх строки, инверсия испортила бы его
+static void updateLoot(void) {
+  if (!MENU_IsActive()) {
+    renderLoot();
+  }
+}
+
+static void renderTopInfo(void) {
+  const uint32_t step = StepFrequencyTable[RADIO_GetParam(ctx, PARAM_STEP)];
 
   PrintSmallEx(0, 12, POS_L, C_FILL, "%uus", SCAN_GetDelay());
   PrintSmallEx(LCD_WIDTH, 12, POS_R, C_FILL, "%u.%02uk", step / 100,
@@ -263,10 +334,15 @@ static void renderTopInfo(void) {
     PrintSmallEx(0, 18, POS_L, C_FILL, "Zoom %u", BANDS_RangeIndex() + 1);
   }
 
-  PrintSmallEx(0, 24, POS_L, C_FILL, "CPS %u", SCAN_GetCps());
+  // справа на 18 и 24 - шкала анализатора
+  PrintSmallEx(0, 24, POS_L, C_FILL, "CPS %u %s%s %s", SCAN_GetCps(),
+               SP_TraceName(),
+               SP_GetTraceOverlay() && SP_GetTrace() ? "+" : "",
+               SP_BinName());
 }
 
-static void renderBottomFreq(uint32_t step) {
+static void renderBottomFreq(void) {
+  const uint32_t step = StepFrequencyTable[RADIO_GetParam(ctx, PARAM_STEP)];
   Band r = CUR_GetRange(&gCurrentBand, step);
   bool showCurRange = (Now() < cursorRangeTimeout);
 
@@ -280,9 +356,8 @@ static void renderBottomFreq(uint32_t step) {
   FSmall(LCD_WIDTH - 1, LCD_HEIGHT - 2, POS_R, rightF);
 }
 
-void SCANER_render(void) {
-  const uint32_t step = StepFrequencyTable[RADIO_GetParam(ctx, PARAM_STEP)];
-
+static void renderSpectrum(void) {
+  lootShownValid = false; // область стёрта
   STATUSLINE_RenderRadioSettings();
 
   // Установка диапазона для спектра
@@ -303,14 +378,45 @@ void SCANER_render(void) {
     SP_RenderArrow(RADIO_GetParam(ctx, PARAM_FREQUENCY));
   }
 
-  renderBottomFreq(step);
   CUR_Render();
 
   if (vfo->is_open) {
     UI_RSSIBar(17);
   }
 
+  // под полосой RSSI, чтобы не пересекаться с подписями строк 12-24
+  char name[11];
+  if (CHANNELS_GetNameByF(RADIO_GetParam(ctx, PARAM_FREQUENCY), name)) {
+    FillRect(LCD_XCENTER - 21, 25, 42, 7, C_CLEAR);
+    PrintSmallEx(LCD_XCENTER, 31, POS_C, C_FILL, "%s", name);
+  }
+
+  // последней перед меню: после неё в области ничего не рисуется
+  renderLoot();
+
   REGSMENU_Draw();
 }
 
-void SCANER_deinit(void) {}
+static void renderWaterfall(void) { WF_Render(WF_PAGE); }
+
+// Меню регистров рисуется поверх водопада, прокрутка его бы сдвинула
+static void scrollWaterfall(void) {
+  if (!MENU_IsActive()) {
+    WF_Scroll(WF_PAGE);
+  }
+}
+
+// Спектр перерисовывается каждый проход, строка частот - только при смене
+// диапазона/курсора (вместе с полной перерисовкой), строка находки - при её
+// смене. Водопад идёт первым, чтобы при полной перерисовке меню спектра легло
+// поверх
+Widget SCANER_WIDGETS[SCANER_WIDGETS_COUNT] = {
+    {WIDGET_WATERFALL, WF_PAGE * 8, WF_ROWS, renderWaterfall, scrollWaterfall},
+    [SCANER_WIDGET_SPECTRUM] = {WIDGET_SPECTRUM, 7, LCD_HEIGHT - 7 - 8,
+                                renderSpectrum},
+    {WIDGET_FREQ, LCD_HEIGHT - 8, 8, renderBottomFreq},
+    {WIDGET_LOOT, 8, 8, renderLoot, updateLoot},
+};
+
+// Водопад - только у сканера, в других приложениях проход его не трогает
+void SCANER_deinit(void) { WF_SetEnabled(false); }
@@ -3,6 +3,7 @@
 
 #include "../driver/keyboard.h"
 #include "../radio.h"
+#include "../ui/widgets.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -10,6 +11,8 @@ bool SCANER_key(KEY_Code_t Key, Key_State_t state);
 void SCANER_init(void);
 void SCANER_deinit(void);
 void SCANER_update(void);
-void SCANER_render(void);
+
+#define SCANER_WIDGETS_COUNT 4
+extern Widget SCANER_WIDGETS[SCANER_WIDGETS_COUNT];
 
 #endif /* end of include guard: SCANER_H */
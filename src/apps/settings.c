@@ -116,6 +116,7 @@ static const MenuItem menuItems[] = {
     {"Beep", SETTING_BEEP, getValS, updateValS},
     {"Main app", SETTING_MAINAPP, getValS, updateValS},
     {"Lock PTT", SETTING_PTT_LOCK, getValS, updateValS},
+    {"Debug apps", SETTING_DEBUGAPPS, getValS, updateValS},
 };
 
 static Menu settingsMenu = {
@@ -132,4 +133,3 @@ bool SETTINGS_key(KEY_Code_t key, Key_State_t state) {
   return MENU_HandleInput(key, state);
 }
 
-void SETTINGS_render(void) { MENU_Render(); }
@@ -8,6 +8,5 @@
 void SETTINGS_init();
 void SETTINGS_deinit();
 bool SETTINGS_key(KEY_Code_t key, Key_State_t state);
-void SETTINGS_render();
 
 #endif /* end of include guard: SETTINGS_H */
@@ -145,6 +145,10 @@ static bool handleLongPress(KEY_Code_t key) {
     RADIO_IncDecParam(ctx, PARAM_MODULATION, true, true);
     return true;
 
+  case KEY_9:
+    SP_NextGraphBase(true);
+    return true;
+
   case KEY_SIDE1:
   case KEY_SIDE2:
     SP_NextGraphUnit(key == KEY_SIDE1);
@@ -289,9 +293,15 @@ static void renderStatusLine(void) {
 }
 
 static void renderBandInfo(uint8_t BASE) {
+  char name[11];
   if (vfo->mode == MODE_CHANNEL) {
     PrintMediumEx(LCD_XCENTER, BASE - 16, POS_C, C_FILL, "%s", ctx->name);
   } else {
+    // частота совпала с сохранённым каналом
+    if (CHANNELS_GetNameByF(ctx->frequency, name)) {
+      PrintMediumEx(LCD_XCENTER, BASE - 16, POS_C, C_FILL, "%s", name);
+    }
+
     const char *format =
         (gCurrentBand.meta.type == TYPE_BAND_DETACHED) ? "*%s" : "%s:%u";
     uint32_t channel = CHANNELS_GetChannel(&gCurrentBand, ctx->frequency) + 1;
@@ -382,9 +392,9 @@ static void renderMonitorMode(uint8_t BASE) {
 
     SP_RenderGraph(graphRanges[graphMeasurement].min,
                    graphRanges[graphMeasurement].max);
-    PrintSmallEx(0, SPECTRUM_Y + 5, POS_L, C_FILL, "%s %+3u",
+    PrintSmallEx(0, SPECTRUM_Y + 5, POS_L, C_FILL, "%s %+3u %s",
                  graphMeasurementNames[graphMeasurement],
-                 SP_GetLastGraphValue());
+                 SP_GetLastGraphValue(), SP_GraphBaseName());
   } else {
     UI_RSSIBar(BASE + 1);
   }
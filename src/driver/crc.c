@@ -24,3 +24,11 @@ uint16_t CRC_Calculate(const void *pBuffer, uint16_t Size) {
 
   return Crc;
 }
+
+// Продолжает CRC с предыдущего значения: IV подхватывается при включении блока
+uint16_t CRC_Continue(uint16_t Crc, const void *pBuffer, uint16_t Size) {
+  CRC_IV = Crc;
+  Crc = CRC_Calculate(pBuffer, Size);
+  CRC_IV = 0;
+  return Crc;
+}
@@ -5,5 +5,6 @@
 
 void CRC_Init(void);
 uint16_t CRC_Calculate(const void *pBuffer, uint16_t Size);
+uint16_t CRC_Continue(uint16_t Crc, const void *pBuffer, uint16_t Size);
 
 #endif
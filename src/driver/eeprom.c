@@ -1,5 +1,6 @@
 #include "eeprom.h"
 #include "../external/printf/printf.h"
+#include "../helper/trace.h"
 #include "../scheduler.h"
 #include "i2c.h"
 #include "system.h"
@@ -128,6 +129,7 @@ void EEPROM_WriteBuffer(uint32_t address, uint8_t *pBuffer, uint16_t size) {
 
   uint16_t PAGE_SIZE = EEPROM_GetPageSize();
   address &= 0x3FFFF;
+  TRACE(TR_EEPROM_WRITE, size, address, 0);
 
   while (size > 0) {
     uint16_t page_offset = address % PAGE_SIZE;
@@ -312,13 +314,45 @@ bool EEPROM_Test(uint32_t test_addr) {
 }
 
 #include "uart.h"
-void EEPROM_TestReadSpeed() {
+// Последовательное чтение [0, size) блоками по 128 байт, байт/с
+uint32_t EEPROM_TestReadSpeed(uint32_t size) {
+  uint8_t buf[128];
+  uint32_t start = GetUptimeUs();
+
+  for (uint32_t i = 0; i < size; i += sizeof(buf)) {
+    EEPROM_ReadBuffer(i, buf, sizeof(buf));
+  }
+
+  uint32_t us = GetUptimeUs() - start;
+  uint32_t ms = (us + 500) / 1000;
+  uint32_t bps = ms ? size * 1000 / ms : 0;
+  Log("EEPROM read %u B in %u us: %u B/s", size, us, bps);
+  return bps;
+}
+
+// Постраничная запись: страницы перезаписываются своим же содержимым,
+// данные не меняются. Байт/с
+uint32_t EEPROM_TestWriteSpeed(uint32_t address, uint8_t pages) {
   uint8_t buf[256];
-  Log("-- EEPROM TEST START --");
-  for (uint32_t i = 0; i < g_eeprom_size; i += g_eeprom_page_size) {
-    EEPROM_ReadBuffer(i, buf, g_eeprom_page_size);
+  uint16_t pageSize = EEPROM_GetPageSize();
+  uint32_t us = 0;
+
+  if (pageSize > sizeof(buf)) {
+    pageSize = sizeof(buf);
+  }
+
+  for (uint8_t i = 0; i < pages; ++i) {
+    uint32_t a = address + i * pageSize;
+    EEPROM_ReadBuffer(a, buf, pageSize);
+    uint32_t start = GetUptimeUs();
+    EEPROM_WriteBuffer(a, buf, pageSize);
+    us += GetUptimeUs() - start;
   }
-  Log("-- EEPROM TEST END --");
+
+  uint32_t ms = (us + 500) / 1000;
+  uint32_t bps = ms ? (uint32_t)pages * pageSize * 1000 / ms : 0;
+  Log("EEPROM write %u pages in %u us: %u B/s", pages, us, bps);
+  return bps;
 }
 
 void EEPROM_ScanBus(void) {
@@ -17,6 +17,7 @@ uint16_t EEPROM_GetPageSize(void);
 uint32_t EEPROM_DetectSize(void);
 void EEPROM_Init(void);
 EEPROMType EEPROM_DetectType(void);
-void EEPROM_TestReadSpeed();
+uint32_t EEPROM_TestReadSpeed(uint32_t size);
+uint32_t EEPROM_TestWriteSpeed(uint32_t address, uint8_t pages);
 
 #endif
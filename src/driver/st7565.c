@@ -1,8 +1,10 @@
 #include "st7565.h"
+#include "../inc/dp32g030/dma.h"
 #include "../inc/dp32g030/gpio.h"
 #include "../inc/dp32g030/spi.h"
 #include "../misc.h"
 #include "../settings.h"
+#include "crc.h"
 #include "gpio.h"
 #include "spi.h"
 #include "system.h"
@@ -18,7 +20,27 @@ static void waitToSend() {
 }
 
 uint8_t gFrameBuffer[8][LCD_WIDTH];
-static uint8_t frameBufferSecond[8][LCD_WIDTH];
+// CRC отправленного содержимого блоков по 16 столбцов вместо копии экрана:
+// 128 байт вместо 1 КБ. Нулевой блок даёт CRC 0, как и пустой экран
+#define HASH_BLOCK 16
+static uint16_t blockHash[8][LCD_WIDTH / HASH_BLOCK];
+
+// CRC только отсеивает блоки, а при совпадении CRC у разного содержимого
+// пиксели на экране остались бы старыми. Поэтому раз в SCRUB_MS одна
+// страница уходит целиком мимо фильтра: весь экран сверяется за 8 * SCRUB_MS
+#define SCRUB_MS 250
+static uint32_t scrubTime;
+static uint8_t scrubPage;
+
+// Изменённые столбцы по страницам, lo > hi - страница чистая
+uint8_t gDirtyLo[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+uint8_t gDirtyHi[8];
+
+// Очередь страниц на отправку: диапазоны столбцов и маска
+static uint8_t sendLo[8];
+static uint8_t sendLen[8];
+static uint8_t sendMask;
+static uint8_t sendPage;
 
 static uint32_t gLastRender;
 bool gRedrawScreen = true;
@@ -59,35 +81,131 @@ static void ST7565_FillScreen(uint8_t Value) {
   SPI_ToggleMasterMode(&SPI0->CR, true);
 }
 
-void ST7565_Blit(void) {
-  uint8_t Line;
-  uint8_t Column;
+// SPI0 TX для DMA - запрос HSREQ 4 (UART1 TX/RX заняли 0 и 1)
+static void StartPage(void) {
+  sendPage = 0;
+  while (!(sendMask & (1 << sendPage))) {
+    sendPage++;
+  }
 
-  SPI_ToggleMasterMode(&SPI0->CR, false);
-  ST7565_WriteByte(0x40);
+  ST7565_SelectColumnAndLine(4U + sendLo[sendPage], sendPage);
+  GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
+
+  DMA_CH2->CTR = 0;
+  DMA_CH2->MSADDR =
+      (uint32_t)(uintptr_t)&gFrameBuffer[sendPage][sendLo[sendPage]];
+  DMA_CH2->CTR = 0 | DMA_CH_CTR_CH_EN_BITS_ENABLE |
+                 (((sendLen[sendPage] - 1) << DMA_CH_CTR_LENGTH_SHIFT) &
+                  DMA_CH_CTR_LENGTH_MASK) |
+                 DMA_CH_CTR_PRI_BITS_LOW;
+}
+
+static void FinishBlit(void) {
+  SPI0->CR &= ~SPI_CR_TXDMAEN_MASK;
+  SPI_ToggleMasterMode(&SPI0->CR, true);
+}
 
-  for (Line = 0; Line < ARRAY_SIZE(gFrameBuffer); Line++) {
-    if (memcmp(gFrameBuffer[Line], frameBufferSecond[Line],
-               ARRAY_SIZE(frameBufferSecond[Line])) == 0) {
+void ST7565_Update(void) {
+  if (!sendMask || !(DMA_INTST & DMA_INTST_CH2_TC_INTST_MASK)) {
+    return;
+  }
+  DMA_INTST = DMA_INTST_CH2_TC_INTST_BITS_SET;
+  // DMA отдал последний байт в FIFO, ждём, пока он уйдёт до смены A0
+  SPI_WaitForUndocumentedTxFifoStatusBit();
+
+  sendMask &= ~(1 << sendPage);
+  if (sendMask) {
+    StartPage();
+  } else {
+    FinishBlit();
+  }
+}
+
+bool ST7565_IsBusy(void) {
+  ST7565_Update();
+  return sendMask != 0;
+}
+
+void ST7565_Sync(void) {
+  while (ST7565_IsBusy()) {
+    continue;
+  }
+}
+
+void ST7565_Invalidate(void) {
+  memset(gDirtyLo, 0, sizeof(gDirtyLo));
+  memset(gDirtyHi, LCD_WIDTH - 1, sizeof(gDirtyHi));
+}
+
+// Запускает передачу изменённых столбцов и сразу возвращается, страницы
+// дальше подаёт ST7565_Update из главного цикла. DMA читает gFrameBuffer,
+// поэтому до конца передачи в него лучше не рисовать (ST7565_IsBusy)
+void ST7565_BlitAsync(void) {
+  ST7565_Sync();
+
+  uint8_t scrub = 0xFF;
+  if (GetUptimeMs() - scrubTime >= SCRUB_MS) {
+    scrubTime = GetUptimeMs();
+    scrub = scrubPage;
+    scrubPage = (scrubPage + 1) % ARRAY_SIZE(gFrameBuffer);
+    gDirtyLo[scrub] = 0;
+    gDirtyHi[scrub] = LCD_WIDTH - 1;
+  }
+
+  for (uint8_t Line = 0; Line < ARRAY_SIZE(gFrameBuffer); Line++) {
+    uint8_t lo = gDirtyLo[Line], hi = gDirtyHi[Line];
+    uint8_t first = 0xFF, last = 0;
+
+    gDirtyLo[Line] = 0xFF;
+    gDirtyHi[Line] = 0;
+
+    // Стёрли и нарисовали то же самое - блок не отправляем
+    for (uint8_t b = lo / HASH_BLOCK; lo <= hi && b <= hi / HASH_BLOCK; ++b) {
+      uint16_t h =
+          CRC_Calculate(&gFrameBuffer[Line][b * HASH_BLOCK], HASH_BLOCK);
+      if (h != blockHash[Line][b] || Line == scrub) {
+        blockHash[Line][b] = h;
+        if (first == 0xFF) {
+          first = b;
+        }
+        last = b;
+      }
+    }
+    if (first == 0xFF) {
       continue;
     }
 
-    ST7565_SelectColumnAndLine(4U, Line);
-    GPIO_SetBit(&GPIOB->DATA, GPIOB_PIN_ST7565_A0);
-    for (Column = 0; Column < ARRAY_SIZE(gFrameBuffer[0]); Column++) {
-      waitToSend();
-      SPI0->WDR = gFrameBuffer[Line][Column];
+    if (lo < first * HASH_BLOCK) {
+      lo = first * HASH_BLOCK;
+    }
+    if (hi > last * HASH_BLOCK + HASH_BLOCK - 1) {
+      hi = last * HASH_BLOCK + HASH_BLOCK - 1;
     }
-    SPI_WaitForUndocumentedTxFifoStatusBit();
 
-    memcpy(frameBufferSecond[Line], gFrameBuffer[Line],
-           ARRAY_SIZE(frameBufferSecond[Line]));
+    sendLo[Line] = lo;
+    sendLen[Line] = hi - lo + 1;
+    sendMask |= 1 << Line;
   }
 
-  SPI_ToggleMasterMode(&SPI0->CR, true);
+  if (!sendMask) {
+    return;
+  }
+
+  SPI_ToggleMasterMode(&SPI0->CR, false);
+  ST7565_WriteByte(0x40);
+  DMA_INTST = DMA_INTST_CH2_TC_INTST_BITS_SET;
+  SPI0->CR |= SPI_CR_TXDMAEN_MASK;
+  StartPage();
+}
+
+void ST7565_Blit(void) {
+  ST7565_BlitAsync();
+  ST7565_Sync();
 }
 
 void ST7565_Init(bool full) {
+  ST7565_Sync();
+
   if (full) {
     SPI0_Init();
     ST7565_Configure_GPIO_B11();
@@ -127,7 +245,20 @@ void ST7565_Init(bool full) {
   SPI_ToggleMasterMode(&SPI0->CR, true);
 
   if (full) {
+    DMA_CH2->CTR = 0;
+    DMA_CH2->MDADDR = (uint32_t)(uintptr_t)&SPI0->WDR;
+    DMA_CH2->MOD = 0
+                   // Source
+                   | DMA_CH_MOD_MS_ADDMOD_BITS_INCREMENT |
+                   DMA_CH_MOD_MS_SIZE_BITS_8BIT | DMA_CH_MOD_MS_SEL_BITS_SRAM
+                   // Destination
+                   | DMA_CH_MOD_MD_ADDMOD_BITS_NONE |
+                   DMA_CH_MOD_MD_SIZE_BITS_8BIT |
+                   DMA_CH_MOD_MD_SEL_BITS_HSREQ_MS4;
+
     ST7565_FillScreen(0x00);
+    memset(blockHash, 0, sizeof(blockHash));
+    ST7565_Invalidate();
   }
 }
 
@@ -13,7 +13,22 @@ extern uint8_t gFrameBuffer[8][LCD_WIDTH];
 static uint32_t gLastRender;
 extern bool gRedrawScreen;
 
+extern uint8_t gDirtyLo[8];
+extern uint8_t gDirtyHi[8];
+
+static inline void ST7565_MarkDirty(uint8_t page, uint8_t lo, uint8_t hi) {
+  if (lo < gDirtyLo[page])
+    gDirtyLo[page] = lo;
+  if (hi > gDirtyHi[page])
+    gDirtyHi[page] = hi;
+}
+
 void ST7565_Blit(void);
+void ST7565_BlitAsync(void);
+void ST7565_Update(void);
+bool ST7565_IsBusy(void);
+void ST7565_Sync(void);
+void ST7565_Invalidate(void);
 void ST7565_Init(bool full);
 void ST7565_WriteByte(uint8_t Value);
 
@@ -15,9 +15,11 @@ void TIMER0_InitAsUptimeCounter(void) {
 }
 static volatile uint32_t uptime_ms = 0;
 static volatile uint16_t accum_us = 0;
+static volatile uint32_t overflows = 0; // периоды HIGH по 65536 мкс
 void HandlerTIMER_BASE0(void) {
   if (TIMER0->IF & 2) {
     TIMER0->IF = 2;
+    overflows++;
     uptime_ms += 65;
     accum_us += 536;
     if (accum_us >= 1000) {
@@ -40,6 +42,16 @@ uint32_t GetUptimeMs(void) {
   uint32_t sub = acc1 + cnt;
   return ms1 + sub / 1000;
 }
+// Микросекунды с включения, переполняется раз в ~71 мин: только для разниц
+uint32_t GetUptimeUs(void) {
+  uint32_t o1, o2, cnt;
+  do {
+    o1 = overflows;
+    cnt = TIMER0->HIGH_CNT;
+    o2 = overflows;
+  } while (o1 != o2);
+  return (o1 << 16) + cnt;
+}
 uint32_t GetUptimeSec(void) { return GetUptimeMs() / 1000; }
 void TIMER1_InitForDelay(void) {
   TIMER1->EN = 0;
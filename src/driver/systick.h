@@ -40,6 +40,7 @@ void TIMER_DelayTicks(uint32_t ticks);
 
 // Uptime (время с момента включения)
 uint32_t GetUptimeMs(void);  // миллисекунды
+uint32_t GetUptimeUs(void);  // микросекунды, для замеров
 uint32_t GetUptimeSec(void); // секунды
 
 #endif
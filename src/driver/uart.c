@@ -4,7 +4,13 @@
 #include "../inc/dp32g030/dma.h"
 #include "../inc/dp32g030/gpio.h"
 #include "../inc/dp32g030/syscon.h"
+#include "../helper/profile.h"
+#include "../helper/scan.h"
+#include "../helper/stream.h"
+#include "../helper/trace.h"
+#include "../radio.h"
 #include "../scheduler.h"
+#include "../settings.h"
 #include "bk4819-regs.h"
 #include "bk4819.h"
 #include "crc.h"
@@ -14,9 +20,18 @@
 #include <stdbool.h>
 #include <string.h>
 
-static const char Version[] = "s0v4";
+// После '+' перечислены расширения протокола: b - bulk read/write,
+// c - CRC блоков для дельта-синхронизации
+static const char Version[] = "s0v4+bc";
 
-static uint8_t UART_DMA_Buffer[256];
+// Выравнивание нужно для разбора команд прямо в буфере DMA
+static uint8_t UART_DMA_Buffer[256] __attribute__((aligned(4)));
+
+// TX кольцо: UART_Send только копирует, DMA_CH1 выгружает в фоне
+static uint8_t UART_TX_Buffer[256];
+static uint16_t txHead; // куда пишем
+static uint16_t txTail; // начало куска, отданного DMA
+static uint16_t txLen;  // длина куска в DMA, 0 - канал свободен
 
 static bool bIsInLockScreen = false;
 
@@ -40,7 +55,7 @@ void UART_Init(void) {
 
   UART1->BAUD = Frequency / 39053U;
   UART1->CTRL = UART_CTRL_RXEN_BITS_ENABLE | UART_CTRL_TXEN_BITS_ENABLE |
-                UART_CTRL_RXDMAEN_BITS_ENABLE;
+                UART_CTRL_RXDMAEN_BITS_ENABLE | UART_CTRL_TXDMAEN_BITS_ENABLE;
   UART1->RXTO = 4;
   UART1->FC = 0;
   UART1->FIFO = UART_FIFO_RF_LEVEL_BITS_8_BYTE | UART_FIFO_RF_CLR_BITS_ENABLE |
@@ -59,6 +74,20 @@ void UART_Init(void) {
                  // Destination
                  | DMA_CH_MOD_MD_ADDMOD_BITS_INCREMENT |
                  DMA_CH_MOD_MD_SIZE_BITS_8BIT | DMA_CH_MOD_MD_SEL_BITS_SRAM;
+
+  // TX: SRAM -> TDR по запросу UART1 TX (HSREQ 0)
+  DMA_CH1->CTR = 0;
+  DMA_CH1->MDADDR = (uint32_t)(uintptr_t)&UART1->TDR;
+  DMA_CH1->MOD = 0
+                 // Source
+                 | DMA_CH_MOD_MS_ADDMOD_BITS_INCREMENT |
+                 DMA_CH_MOD_MS_SIZE_BITS_8BIT | DMA_CH_MOD_MS_SEL_BITS_SRAM
+                 // Destination
+                 | DMA_CH_MOD_MD_ADDMOD_BITS_NONE |
+                 DMA_CH_MOD_MD_SIZE_BITS_8BIT |
+                 DMA_CH_MOD_MD_SEL_BITS_HSREQ_MS0;
+  txHead = txTail = txLen = 0;
+
   DMA_INTEN = 0;
   DMA_INTST =
       0 | DMA_INTST_CH0_TC_INTST_BITS_SET | DMA_INTST_CH1_TC_INTST_BITS_SET |
@@ -75,20 +104,87 @@ void UART_Init(void) {
   UART1->CTRL |= UART_CTRL_UARTEN_BITS_ENABLE;
 }
 
+// Забирает завершённый кусок и отдаёт DMA следующий непрерывный
+static void TxKick(void) {
+  if (txLen) {
+    if (!(DMA_INTST & DMA_INTST_CH1_TC_INTST_MASK)) {
+      return;
+    }
+    DMA_INTST = DMA_INTST_CH1_TC_INTST_BITS_SET;
+    txTail = (txTail + txLen) % sizeof(UART_TX_Buffer);
+    txLen = 0;
+  }
+
+  if (txTail == txHead) {
+    return;
+  }
+
+  txLen = (txHead > txTail ? txHead : sizeof(UART_TX_Buffer)) - txTail;
+  DMA_CH1->CTR = 0;
+  DMA_CH1->MSADDR = (uint32_t)(uintptr_t)(UART_TX_Buffer + txTail);
+  DMA_CH1->CTR = 0 | DMA_CH_CTR_CH_EN_BITS_ENABLE |
+                 (((txLen - 1) << DMA_CH_CTR_LENGTH_SHIFT) &
+                  DMA_CH_CTR_LENGTH_MASK) |
+                 DMA_CH_CTR_PRI_BITS_LOW;
+}
+
+void UART_Update(void) { TxKick(); }
+
+bool UART_IsTxIdle(void) {
+  TxKick();
+  return !txLen && txTail == txHead;
+}
+
+static uint16_t TxFree(void) {
+  return (txTail + sizeof(UART_TX_Buffer) - txHead - 1) %
+         sizeof(UART_TX_Buffer);
+}
+
+// Блокирует только если кольцо заполнено
 void UART_Send(const void *pBuffer, uint32_t Size) {
   const uint8_t *pData = (const uint8_t *)pBuffer;
-  uint32_t i;
 
-  for (i = 0; i < Size; i++) {
-    UART1->TDR = pData[i];
-    while ((UART1->IF & UART_IF_TXFIFO_FULL_MASK) !=
-           UART_IF_TXFIFO_FULL_BITS_NOT_SET) {
+  while (Size) {
+    uint16_t Free = TxFree();
+    uint16_t n = sizeof(UART_TX_Buffer) - txHead;
+
+    if (!Free) {
+      TxKick();
+      continue;
+    }
+    if (n > Free) {
+      n = Free;
+    }
+    if (n > Size) {
+      n = Size;
     }
+
+    memcpy(UART_TX_Buffer + txHead, pData, n);
+    txHead = (txHead + n) % sizeof(UART_TX_Buffer);
+    pData += n;
+    Size -= n;
   }
+
+  TxKick();
 }
 
 #define DMA_INDEX(x, y) (((x) + (y)) % sizeof(UART_DMA_Buffer))
 
+// Bulk write: кадр 64 байта данных + 20 байт обвязки, в кольцо DMA на 256
+// байт без риска перезаписи влезают два кадра в полёте
+#define BULK_CHUNK 64
+#define BULK_WINDOW 2
+// Точек развёртки в одном ответе
+#define SWEEP_CHUNK 64
+// Ограничения одной развёртки: главный цикл стоит, пока она идёт
+#define SWEEP_POINTS_MAX 8192
+#define SWEEP_TIME_MAX_US 30000000ULL
+#define SWEEP_POINT_OVERHEAD_US 100 // перестройка частоты и чтение RSSI
+// Столько CRC помещается в один ответ; размер блока ограничен, чтобы запрос
+// читал не больше 16 КБ
+#define BLOCK_CRC_MAX 64
+#define BLOCK_CRC_SIZE_MAX 256
+
 typedef struct {
   uint16_t ID;
   uint16_t Size;
@@ -167,6 +263,8 @@ typedef struct {
 typedef struct {
   Header_t Header;
   uint8_t RegNum;
+  uint8_t Padding[3];
+  uint32_t Timestamp;
 } CMD_0601_t;
 
 typedef struct {
@@ -182,6 +280,7 @@ typedef struct {
   Header_t Header;
   uint8_t RegNum;
   uint16_t RegValue;
+  uint32_t Timestamp;
 } CMD_0602_t;
 
 typedef struct {
@@ -193,6 +292,147 @@ typedef struct {
   } Data;
 } REPLY_0602_t;
 
+typedef struct {
+  Header_t Header;
+  uint32_t StartF;
+  uint32_t EndF;
+  uint32_t Step;
+  uint16_t DwellUs;
+  uint8_t Avg;
+  uint8_t Padding;
+  uint32_t Timestamp;
+} CMD_0543_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint16_t Index;
+    uint8_t Count;
+    uint8_t Padding;
+    uint16_t Rssi[SWEEP_CHUNK];
+  } Data;
+} REPLY_0544_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Count;
+    uint32_t TimeMs;
+    bool bOk; // false - запрос вне ограничений, развёртки не было
+    uint8_t Padding[3];
+  } Data;
+} REPLY_0545_t;
+
+typedef struct {
+  Header_t Header;
+  uint32_t Offset;
+  uint32_t Length;
+  uint32_t Timestamp;
+} CMD_0530_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Offset;
+    uint32_t Length;
+    uint16_t Crc;
+    uint8_t Padding[2];
+  } Data;
+} REPLY_0532_t;
+
+typedef CMD_0530_t CMD_0533_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Offset;
+    uint8_t Window;
+    uint8_t Padding[3];
+  } Data;
+} REPLY_0534_t;
+
+typedef struct {
+  Header_t Header;
+  uint32_t Offset;
+  uint8_t Size;
+  uint8_t Padding[3];
+  uint8_t Data[BULK_CHUNK];
+} CMD_0535_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Offset;
+    bool bOk;
+    bool bDenied; // кадр задевает пароль при заблокированном экране
+    uint8_t Padding[2];
+  } Data;
+} REPLY_0536_t;
+
+typedef struct {
+  Header_t Header;
+  uint32_t Offset;
+  uint32_t Length;
+  uint16_t Crc;
+  uint8_t Padding[2];
+  uint32_t Timestamp;
+} CMD_0537_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint16_t Crc;
+    bool bOk;
+    uint8_t Padding;
+  } Data;
+} REPLY_0538_t;
+
+typedef struct {
+  Header_t Header;
+  bool bReset;
+} CMD_0546_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint8_t Stages;
+    uint8_t Buckets;
+    uint8_t Padding[2];
+    ProfStat Stats[PROF_COUNT];
+  } Data;
+} REPLY_0546_t;
+
+typedef struct {
+  Header_t Header;
+  uint8_t Mode;
+} CMD_0541_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint8_t Mode;
+    uint8_t Padding[3];
+  } Data;
+} REPLY_0541_t;
+
+typedef struct {
+  Header_t Header;
+  uint32_t Offset;
+  uint16_t BlockSize;
+  uint16_t Count;
+  uint32_t Timestamp;
+} CMD_0539_t;
+
+typedef struct {
+  Header_t Header;
+  struct {
+    uint32_t Offset;
+    uint16_t BlockSize;
+    uint16_t Count;
+    uint16_t Crc[BLOCK_CRC_MAX];
+  } Data;
+} REPLY_0539_t;
+
 static const uint8_t Obfuscation[16] = {0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91,
                                         0x0D, 0x40, 0x21, 0x35, 0xD5, 0x40,
                                         0x13, 0x03, 0xE9, 0x80};
@@ -203,12 +443,22 @@ static union {
     Header_t Header;
     uint8_t Data[252];
   };
-} UART_Command;
+} UART_Command __attribute__((aligned(4)));
+
+// Текущая команда: в UART_DMA_Buffer или в UART_Command
+static uint8_t *pCommand;
 
 static uint32_t Timestamp;
 static uint16_t gUART_WriteIndex;
 static bool bIsEncrypted = true;
 
+static struct {
+  uint32_t Start;
+  uint32_t Offset;
+  uint32_t End;
+  bool bActive;
+} BulkWrite;
+
 static Header_t Header;
 static Footer_t Footer;
 static uint8_t *pBytes;
@@ -238,9 +488,20 @@ static void SendReply(void *pReply, uint16_t Size) {
   UART_Send(&Footer, sizeof(Footer));
 }
 
+// Неблокирующая отправка для потоков: нет места в TX - кадр не отправляется
+bool UART_SendFrame(void *pFrame, uint16_t Size) {
+  TxKick();
+  if (TxFree() < Size + sizeof(Header) + sizeof(Footer)) {
+    return false;
+  }
+  SendReply(pFrame, Size);
+  return true;
+}
+
 static void SendVersion(void) {
   REPLY_0514_t Reply;
 
+  memset(&Reply, 0, sizeof(Reply));
   Reply.Header.ID = 0x0515;
   Reply.Header.Size = sizeof(Reply.Data);
   strcpy(Reply.Data.Version, Version);
@@ -277,6 +538,16 @@ static void CMD_051B(const uint8_t *pBuffer) {
   SendReply(&Reply, pCmd->Size + 8 + 4);
 }
 
+static bool IsWriteAllowed(uint32_t Offset, bool bAllowPassword) {
+  return (Offset < 0x0E98 || Offset >= 0x0EA0) || !bIsInLockScreen ||
+         bAllowPassword;
+}
+
+// Весь диапазон [Offset, Offset + Size) вне пароля 0x0E98-0x0E9F
+static bool IsRangeWriteAllowed(uint32_t Offset, uint32_t Size) {
+  return Offset + Size <= 0x0E98 || Offset >= 0x0EA0 || !bIsInLockScreen;
+}
+
 static void CMD_051D(const uint8_t *pBuffer) {
   const CMD_051D_t *pCmd = (const CMD_051D_t *)pBuffer;
   REPLY_051D_t Reply;
@@ -294,8 +565,7 @@ static void CMD_051D(const uint8_t *pBuffer) {
   for (i = 0; i < (pCmd->Size / 8U); i++) {
     uint32_t Offset = pCmd->Offset + (i * 8U);
 
-    if ((Offset < 0x0E98 || Offset >= 0x0EA0) || !bIsInLockScreen ||
-        pCmd->bAllowPassword) {
+    if (IsWriteAllowed(Offset, pCmd->bAllowPassword)) {
       EEPROM_WriteBuffer(Offset, (void *)&pCmd->Data[i * 8U], 8);
     }
   }
@@ -312,6 +582,316 @@ static void CMD_052F(const uint8_t *pBuffer) {
   SendVersion();
 }
 
+// Bulk read: весь диапазон уходит потоком ответов 0x0531 без запросов на
+// каждый блок, в конце 0x0532 с CRC16 всех отданных данных
+static void CMD_0530(const uint8_t *pBuffer) {
+  const CMD_0530_t *pCmd = (const CMD_0530_t *)pBuffer;
+  REPLY_051B_t Reply;
+  REPLY_0532_t Done;
+  uint32_t Offset = pCmd->Offset;
+  uint32_t End = pCmd->Offset + pCmd->Length;
+  uint16_t Crc = 0;
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  while (Offset < End) {
+    uint8_t Size =
+        End - Offset < sizeof(Reply.Data.Data) ? End - Offset
+                                               : sizeof(Reply.Data.Data);
+
+    memset(&Reply, 0, sizeof(Reply));
+    Reply.Header.ID = 0x0531;
+    Reply.Header.Size = Size + 8 + 4;
+    Reply.Data.Offset = Offset;
+    Reply.Data.Size = Size;
+
+    EEPROM_ReadBuffer(Offset, Reply.Data.Data, Size);
+    Crc = CRC_Continue(Crc, Reply.Data.Data, Size);
+
+    // SendReply обфусцирует буфер на месте, CRC считаем до отправки
+    SendReply(&Reply, Size + 8 + 4);
+    Offset += Size;
+  }
+
+  memset(&Done, 0, sizeof(Done));
+  Done.Header.ID = 0x0532;
+  Done.Header.Size = sizeof(Done.Data);
+  Done.Data.Offset = pCmd->Offset;
+  Done.Data.Length = pCmd->Length;
+  Done.Data.Crc = Crc;
+  SendReply(&Done, sizeof(Done));
+}
+
+// Bulk write: открывает сессию, хост держит до Window кадров в полёте
+static void CMD_0533(const uint8_t *pBuffer) {
+  const CMD_0533_t *pCmd = (const CMD_0533_t *)pBuffer;
+  REPLY_0534_t Reply;
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  BulkWrite.Start = pCmd->Offset;
+  BulkWrite.Offset = pCmd->Offset;
+  BulkWrite.End = pCmd->Offset + pCmd->Length;
+  BulkWrite.bActive = true;
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0534;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Offset = BulkWrite.Offset;
+  Reply.Data.Window = BULK_WINDOW;
+  SendReply(&Reply, sizeof(Reply));
+}
+
+// Кадр данных. Подтверждение кумулятивное: в ответе следующий ожидаемый
+// offset, при разрыве последовательности хост откатывается к нему.
+// Кадр, задевающий пароль, не пишется и не подтверждается, сессия закрыта
+static void CMD_0535(const uint8_t *pBuffer) {
+  const CMD_0535_t *pCmd = (const CMD_0535_t *)pBuffer;
+  REPLY_0536_t Reply;
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0536;
+  Reply.Header.Size = sizeof(Reply.Data);
+
+  if (BulkWrite.bActive && pCmd->Offset == BulkWrite.Offset &&
+      pCmd->Size <= BULK_CHUNK &&
+      pCmd->Offset + pCmd->Size <= BulkWrite.End) {
+    if (IsRangeWriteAllowed(pCmd->Offset, pCmd->Size)) {
+      EEPROM_WriteBuffer(pCmd->Offset, (uint8_t *)pCmd->Data, pCmd->Size);
+      BulkWrite.Offset += pCmd->Size;
+      Reply.Data.bOk = true;
+    } else {
+      BulkWrite.bActive = false;
+      Reply.Data.bDenied = true;
+    }
+  }
+
+  Reply.Data.Offset = BulkWrite.Offset;
+  SendReply(&Reply, sizeof(Reply));
+}
+
+// Завершение: перечитываем записанное и сверяем CRC с хостом. Читается
+// только диапазон открытой сессии, чужой запрос EEPROM не трогает
+static void CMD_0537(const uint8_t *pBuffer) {
+  const CMD_0537_t *pCmd = (const CMD_0537_t *)pBuffer;
+  REPLY_0538_t Reply;
+  uint8_t Chunk[BULK_CHUNK];
+  uint32_t Offset = pCmd->Offset;
+  uint32_t End = pCmd->Offset + pCmd->Length;
+  uint16_t Crc = 0;
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0538;
+  Reply.Header.Size = sizeof(Reply.Data);
+
+  if (BulkWrite.bActive && Offset == BulkWrite.Start &&
+      End == BulkWrite.End && BulkWrite.Offset == BulkWrite.End) {
+    while (Offset < End) {
+      uint8_t Size =
+          End - Offset < sizeof(Chunk) ? End - Offset : sizeof(Chunk);
+      EEPROM_ReadBuffer(Offset, Chunk, Size);
+      Crc = CRC_Continue(Crc, Chunk, Size);
+      Offset += Size;
+    }
+    Reply.Data.Crc = Crc;
+    Reply.Data.bOk = Crc == pCmd->Crc;
+  }
+
+  BulkWrite.bActive = false;
+  SendReply(&Reply, sizeof(Reply));
+}
+
+// CRC16 по каждому блоку диапазона: хост сверяет со своим образом и шлёт
+// только отличающиеся блоки. Размер блока ограничен, блоки за концом
+// EEPROM отбрасываются - в ответе фактические BlockSize и Count
+static void CMD_0539(const uint8_t *pBuffer) {
+  const CMD_0539_t *pCmd = (const CMD_0539_t *)pBuffer;
+  REPLY_0539_t Reply;
+  uint8_t Chunk[BULK_CHUNK];
+  uint32_t Offset = pCmd->Offset;
+  uint16_t BlockSize = pCmd->BlockSize;
+  uint16_t Count = pCmd->Count;
+  const uint32_t EepromSize = SETTINGS_GetEEPROMSize();
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  if (BlockSize > BLOCK_CRC_SIZE_MAX) {
+    BlockSize = BLOCK_CRC_SIZE_MAX;
+  }
+  if (Count > BLOCK_CRC_MAX) {
+    Count = BLOCK_CRC_MAX;
+  }
+  if (!BlockSize || Offset >= EepromSize) {
+    Count = 0;
+  } else if (Count > (EepromSize - Offset) / BlockSize) {
+    Count = (EepromSize - Offset) / BlockSize;
+  }
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x053A;
+  Reply.Header.Size = 8 + Count * 2;
+  Reply.Data.Offset = pCmd->Offset;
+  Reply.Data.BlockSize = BlockSize;
+  Reply.Data.Count = Count;
+
+  for (uint16_t i = 0; i < Count; i++) {
+    uint16_t Left = BlockSize;
+    uint16_t Crc = 0;
+
+    while (Left) {
+      uint8_t Size = Left < sizeof(Chunk) ? Left : sizeof(Chunk);
+      EEPROM_ReadBuffer(Offset, Chunk, Size);
+      Crc = CRC_Continue(Crc, Chunk, Size);
+      Offset += Size;
+      Left -= Size;
+    }
+
+    Reply.Data.Crc[i] = Crc;
+  }
+
+  SendReply(&Reply, sizeof(Header_t) + 8 + Count * 2);
+}
+
+static void CMD_0601(const uint8_t *pBuffer) {
+  const CMD_0601_t *pCmd = (const CMD_0601_t *)pBuffer;
+  REPLY_0601_t Reply;
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0602;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Val = BK4819_ReadRegister(pCmd->RegNum);
+  Reply.Data.v1 = pCmd->RegNum;
+  SendReply(&Reply, sizeof(Reply));
+}
+
+static void CMD_0602(const uint8_t *pBuffer) {
+  const CMD_0602_t *pCmd = (const CMD_0602_t *)pBuffer;
+  REPLY_0602_t Reply;
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  BK4819_WriteRegister(pCmd->RegNum, pCmd->RegValue);
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0603;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Val = BK4819_ReadRegister(pCmd->RegNum);
+  Reply.Data.v1 = pCmd->RegNum;
+  SendReply(&Reply, sizeof(Reply));
+}
+
+// Развёртка по запросу: UI стоит, пока команда выполняется. Точки уходят
+// пачками 0x0544, в конце 0x0545 с числом точек и временем
+static void CMD_0543(const uint8_t *pBuffer) {
+  const CMD_0543_t *pCmd = (const CMD_0543_t *)pBuffer;
+  REPLY_0544_t Reply;
+  REPLY_0545_t Done;
+  uint32_t f0 = RADIO_GetParam(ctx, PARAM_FREQUENCY);
+  uint32_t precise0 = RADIO_GetParam(ctx, PARAM_PRECISE_F_CHANGE);
+  uint32_t start = Now();
+  uint32_t n = 0;
+  uint8_t avg = pCmd->Avg ? pCmd->Avg : 1;
+
+  if (pCmd->Timestamp != Timestamp) {
+    return;
+  }
+
+  // Диапазон обрезается до рабочего, число точек считается заранее без
+  // переполнения, цикл идёт по индексу, а не по частоте
+  uint32_t startF = pCmd->StartF < BK4819_F_MIN ? BK4819_F_MIN : pCmd->StartF;
+  uint32_t endF = pCmd->EndF > BK4819_F_MAX ? BK4819_F_MAX : pCmd->EndF;
+  uint32_t count = 0;
+  if (pCmd->Step && startF <= endF) {
+    count = (endF - startF) / pCmd->Step + 1;
+  }
+  bool bOk = count && count <= SWEEP_POINTS_MAX &&
+             (uint64_t)count * avg * (pCmd->DwellUs + SWEEP_POINT_OVERHEAD_US) <=
+                 SWEEP_TIME_MAX_US;
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0544;
+
+  for (uint32_t p = 0; bOk && p < count; ++p) {
+    const uint32_t f = startF + p * pCmd->Step;
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < avg; i++) {
+      sum += SCAN_Measure(f, pCmd->DwellUs);
+    }
+    Reply.Data.Rssi[Reply.Data.Count++] = sum / avg;
+    n++;
+
+    if (Reply.Data.Count == SWEEP_CHUNK || p + 1 == count) {
+      uint8_t size = Reply.Data.Count;
+      Reply.Header.ID = 0x0544;
+      Reply.Header.Size = 4 + size * 2;
+      SendReply(&Reply, sizeof(Header_t) + 4 + size * 2);
+      memset(&Reply, 0, sizeof(Reply));
+      Reply.Data.Index = n;
+    }
+  }
+
+  // SCAN_Measure оставляет точную перестройку - возвращаем и её, и частоту
+  RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, precise0, false);
+  RADIO_SetParam(ctx, PARAM_FREQUENCY, f0, false);
+  RADIO_ApplySettings(ctx);
+
+  memset(&Done, 0, sizeof(Done));
+  Done.Header.ID = 0x0545;
+  Done.Header.Size = sizeof(Done.Data);
+  Done.Data.Count = n;
+  Done.Data.TimeMs = Now() - start;
+  Done.Data.bOk = bOk;
+  SendReply(&Done, sizeof(Done));
+}
+
+// Гистограммы задержек главного цикла, порядок этапов как в ProfStage
+static void CMD_0546(const uint8_t *pBuffer) {
+  const CMD_0546_t *pCmd = (const CMD_0546_t *)pBuffer;
+  REPLY_0546_t Reply;
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0547;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Stages = PROF_COUNT;
+  Reply.Data.Buckets = PROF_BUCKETS;
+  for (uint8_t i = 0; i < PROF_COUNT; ++i) {
+    Reply.Data.Stats[i] = *PROF_Get(i);
+  }
+  if (pCmd->bReset) {
+    PROF_Reset();
+  }
+  SendReply(&Reply, sizeof(Reply));
+}
+
+static void CMD_0541(const uint8_t *pBuffer) {
+  const CMD_0541_t *pCmd = (const CMD_0541_t *)pBuffer;
+  REPLY_0541_t Reply;
+
+  STREAM_SetMode(pCmd->Mode <= STREAM_FULL ? pCmd->Mode : STREAM_OFF);
+
+  memset(&Reply, 0, sizeof(Reply));
+  Reply.Header.ID = 0x0542;
+  Reply.Header.Size = sizeof(Reply.Data);
+  Reply.Data.Mode = STREAM_GetMode();
+  SendReply(&Reply, sizeof(Reply));
+}
+
 bool UART_IsCommandAvailable(void) {
   uint16_t DmaLength;
   uint16_t CommandLength;
@@ -366,41 +946,38 @@ bool UART_IsCommandAvailable(void) {
     gUART_WriteIndex = DmaLength;
     return false;
   }
-  if (TailIndex < Index) {
-    uint16_t ChunkSize = sizeof(UART_DMA_Buffer) - Index;
-
-    memcpy(UART_Command.Buffer, UART_DMA_Buffer + Index, ChunkSize);
-    memcpy(UART_Command.Buffer + ChunkSize, UART_DMA_Buffer, TailIndex);
+  // Кадр целиком и выровнен - разбираем на месте, иначе собираем копию
+  if (TailIndex > Index && !(Index & 3)) {
+    pCommand = UART_DMA_Buffer + Index;
   } else {
-    memcpy(UART_Command.Buffer, UART_DMA_Buffer + Index, TailIndex - Index);
-  }
+    if (TailIndex < Index) {
+      uint16_t ChunkSize = sizeof(UART_DMA_Buffer) - Index;
 
-  TailIndex = DMA_INDEX(TailIndex, 2);
-  if (TailIndex < gUART_WriteIndex) {
-    memset(UART_DMA_Buffer + gUART_WriteIndex, 0,
-           sizeof(UART_DMA_Buffer) - gUART_WriteIndex);
-    memset(UART_DMA_Buffer, 0, TailIndex);
-  } else {
-    memset(UART_DMA_Buffer + gUART_WriteIndex, 0, TailIndex - gUART_WriteIndex);
+      memcpy(UART_Command.Buffer, UART_DMA_Buffer + Index, ChunkSize);
+      memcpy(UART_Command.Buffer + ChunkSize, UART_DMA_Buffer, TailIndex);
+    } else {
+      memcpy(UART_Command.Buffer, UART_DMA_Buffer + Index, TailIndex - Index);
+    }
+    pCommand = UART_Command.Buffer;
   }
 
-  gUART_WriteIndex = TailIndex;
+  gUART_WriteIndex = DMA_INDEX(TailIndex, 2);
 
-  if (UART_Command.Header.ID == 0x0514) {
+  if (((Header_t *)pCommand)->ID == 0x0514) {
     bIsEncrypted = false;
   }
-  if (UART_Command.Header.ID == 0x6902) {
+  if (((Header_t *)pCommand)->ID == 0x6902) {
     bIsEncrypted = true;
   }
 
   if (bIsEncrypted) {
     for (i = 0; i < Size + 2; i++) {
-      UART_Command.Buffer[i] ^= Obfuscation[i % 16];
+      pCommand[i] ^= Obfuscation[i % 16];
     }
   }
 
-  CRC = UART_Command.Buffer[Size] | (UART_Command.Buffer[Size + 1] << 8);
-  if (CRC_Calculate(UART_Command.Buffer, Size) != CRC) {
+  CRC = pCommand[Size] | (pCommand[Size + 1] << 8);
+  if (CRC_Calculate(pCommand, Size) != CRC) {
     return false;
   }
 
@@ -408,25 +985,68 @@ bool UART_IsCommandAvailable(void) {
 }
 
 void UART_HandleCommand(void) {
-  switch (UART_Command.Header.ID) {
+  TRACE(TR_UART_CMD, ((Header_t *)pCommand)->ID, 0, 0);
+  switch (((Header_t *)pCommand)->ID) {
     // VERSION
   case 0x0514:
-    CMD_0514(UART_Command.Buffer);
+    CMD_0514(pCommand);
     break;
 
     // EEPROM READ
   case 0x051B:
-    CMD_051B(UART_Command.Buffer);
+    CMD_051B(pCommand);
     break;
 
     // EEPROM WRITE
   case 0x051D:
-    CMD_051D(UART_Command.Buffer);
+    CMD_051D(pCommand);
+    break;
+
+    // BULK EEPROM READ / WRITE
+  case 0x0530:
+    CMD_0530(pCommand);
+    break;
+  case 0x0533:
+    CMD_0533(pCommand);
+    break;
+  case 0x0535:
+    CMD_0535(pCommand);
+    break;
+  case 0x0537:
+    CMD_0537(pCommand);
+    break;
+
+    // EEPROM BLOCK CRC
+  case 0x0539:
+    CMD_0539(pCommand);
+    break;
+
+    // SPECTRUM STREAM ON/OFF
+  case 0x0541:
+    CMD_0541(pCommand);
+    break;
+
+    // SWEEP
+  case 0x0543:
+    CMD_0543(pCommand);
+    break;
+
+    // MAIN LOOP LATENCY
+  case 0x0546:
+    CMD_0546(pCommand);
+    break;
+
+    // BK4819 REGISTER READ / WRITE
+  case 0x0601:
+    CMD_0601(pCommand);
+    break;
+  case 0x0602:
+    CMD_0602(pCommand);
     break;
 
     // VERSION, BL OFF
   case 0x052F:
-    CMD_052F(UART_Command.Buffer);
+    CMD_052F(pCommand);
     break;
 
     // RESET
@@ -436,6 +1056,31 @@ void UART_HandleCommand(void) {
   }
 }
 
+// Долгие команды: держат главный цикл на всём диапазоне чтения/развёртки,
+// в сканере не выполняются
+bool UART_IsLongCommand(void) {
+  switch (((Header_t *)pCommand)->ID) {
+  case 0x0530:
+  case 0x0539:
+  case 0x0543:
+    return true;
+  }
+  return false;
+}
+
+// Команды клонирования: трогают EEPROM, в сканере не выполняются
+bool UART_IsCloneCommand(void) {
+  switch (((Header_t *)pCommand)->ID) {
+  case 0x051D:
+  case 0x0533:
+  case 0x0535:
+  case 0x0537:
+  case 0x05DD:
+    return true;
+  }
+  return false;
+}
+
 void LogUart(const char *const str) { UART_Send(str, strlen(str)); }
 
 void UART_printf(const char *str, ...) {
@@ -62,12 +62,18 @@ typedef enum {
 
 void UART_Init(void);
 void UART_Send(const void *pBuffer, uint32_t Size);
+void UART_Update(void);
+bool UART_IsTxIdle(void);
+bool UART_SendFrame(void *pFrame, uint16_t Size);
 
 bool UART_IsCommandAvailable(void);
 void UART_HandleCommand(void);
+bool UART_IsCloneCommand(void);
+bool UART_IsLongCommand(void);
 void Log(const char *pattern, ...);
 void LogC(LogColor c, const char *pattern, ...);
 void LogUart(const char *const str);
+void UART_printf(const char *str, ...);
 void PrintCh(uint16_t chNum, CH *ch);
 
 #endif
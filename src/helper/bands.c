@@ -5,6 +5,7 @@
 #include "channels.h"
 #include "measurements.h"
 #include <stdint.h>
+#include <string.h>
 
 // NOTE
 // for SCAN use cached band by index
@@ -38,6 +39,14 @@ static DBand allBands[BANDS_COUNT_MAX];
 static int16_t allBandIndex; // -1 if default is current
 static uint8_t allBandsSize = 0;
 
+// Индекс: отсортированные непересекающиеся отрезки [segStart[i], next),
+// в каждом выигрывает самый узкий диапазон. Промежутки без диапазонов
+// не хранятся: отрезок кончается не позже allBands[segBand[i]].e
+#define BAND_SEGMENTS_MAX (BANDS_COUNT_MAX * 2)
+static uint32_t segStart[BAND_SEGMENTS_MAX];
+static uint8_t segBand[BAND_SEGMENTS_MAX];
+static uint8_t segCount = 0;
+
 static uint8_t scanlistBandIndex;
 
 static Band rangesStack[RANGES_STACK_SIZE] = {0};
@@ -51,7 +60,7 @@ static int8_t rangesStackIndex = -1;
 
 static const PowerCalibration DEFAULT_POWER_CALIB = {43, 68, 140};
 
-PCal POWER_CALIBRATIONS[] = {
+static const PCal POWER_CALIBRATIONS[] = {
     {.s = 135 * MHZ, .e = 165 * MHZ, .c = {38, 65, 140}},
     {.s = 165 * MHZ, .e = 205 * MHZ, .c = {36, 52, 140}},
     {.s = 205 * MHZ, .e = 215 * MHZ, .c = {41, 64, 135}},
@@ -70,7 +79,8 @@ PCal POWER_CALIBRATIONS[] = {
     {.s = 470 * MHZ, .e = 620 * MHZ, .c = {46, 77, 140}},
 };
 
-static int16_t bandIndexByFreq(uint32_t f, bool preciseStep) {
+// самый узкий диапазон, содержащий f
+static int16_t narrowestBand(uint32_t f, bool preciseStep) {
   int16_t newBandIndex = -1;
   uint32_t smallestDiff = UINT32_MAX;
   for (uint8_t i = 0; i < allBandsSize; ++i) {
@@ -90,7 +100,69 @@ static int16_t bandIndexByFreq(uint32_t f, bool preciseStep) {
   return newBandIndex;
 }
 
+static int16_t bandIndexByFreq(uint32_t f, bool preciseStep) {
+  // последний отрезок с началом <= f
+  uint8_t lo = 0, hi = segCount;
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    if (segStart[mid] <= f) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) {
+    return -1;
+  }
+  uint8_t i = segBand[lo - 1];
+  if (f > allBands[i].e) {
+    return -1;
+  }
+  if (preciseStep && (f % StepFrequencyTable[allBands[i].step])) {
+    // победитель не по сетке, ищем следующий по ширине
+    return narrowestBand(f, true);
+  }
+  return i;
+}
+
+static void buildBandIndex(void) {
+  uint32_t points[BAND_SEGMENTS_MAX];
+  uint8_t n = 0;
+
+  // границы отрезков: начала и конец+1, сортировка вставками без повторов
+  for (uint8_t i = 0; i < allBandsSize; ++i) {
+    uint32_t bounds[2] = {allBands[i].s, allBands[i].e + 1};
+    for (uint8_t k = 0; k < 2; ++k) {
+      uint32_t p = bounds[k];
+      uint8_t j = n;
+      while (j > 0 && points[j - 1] > p) {
+        j--;
+      }
+      if (j > 0 && points[j - 1] == p) {
+        continue;
+      }
+      memmove(&points[j + 1], &points[j], (n - j) * sizeof(points[0]));
+      points[j] = p;
+      n++;
+    }
+  }
+
+  segCount = 0;
+  int16_t prev = -1;
+  for (uint8_t k = 0; k < n; ++k) {
+    int16_t band = narrowestBand(points[k], false);
+    if (band >= 0 && band != prev) {
+      segStart[segCount] = points[k];
+      segBand[segCount] = band;
+      segCount++;
+    }
+    prev = band;
+  }
+  Log("[BANDS] %u bands, %u segments", allBandsSize, segCount);
+}
+
 void BANDS_Load(void) {
+  allBandsSize = 0;
   for (int16_t chNum = 0; chNum < CHANNELS_GetCountMax() - 2; ++chNum) {
     if (CHANNELS_GetMeta(chNum).type != TYPE_BAND) {
       continue;
@@ -111,6 +183,7 @@ void BANDS_Load(void) {
       break;
     }
   }
+  buildBandIndex();
 }
 
 bool BANDS_InRange(const uint32_t f, const Band p) {
@@ -132,13 +205,11 @@ void BANDS_SetRadioParamsFromCurrentBand() {
 void BANDS_Select(int16_t num, bool copyToVfo) {
   CHANNELS_Load(num, &gCurrentBand);
   Log("Select Band %s", gCurrentBand.name);
-  for (int16_t i = 0; i < gScanlistSize; ++i) {
-    if (gScanlist[i] == num) {
-      scanlistBandIndex = i;
-      allBandIndex = bandIndexByFreq(gCurrentBand.rxF, true);
-      // Log("SL band index %u", i);
-      break;
-    }
+  int16_t i = CHANNELS_ScanlistIndexOf(num);
+  if (i >= 0) {
+    scanlistBandIndex = i;
+    allBandIndex = bandIndexByFreq(gCurrentBand.rxF, true);
+    // Log("SL band index %u", i);
   }
   if (!BANDS_InRange(ctx->frequency, gCurrentBand)) {
     // Log("[BAND] !in range");
@@ -159,7 +230,7 @@ void BANDS_Select(int16_t num, bool copyToVfo) {
 void BANDS_SelectScan(int8_t i) {
   if (gScanlistSize) {
     scanlistBandIndex = i;
-    // RADIO_TuneToBand(gScanlist[i]);
+    // RADIO_TuneToBand(CHANNELS_ScanlistAt(i));
   }
 }
 
@@ -199,7 +270,7 @@ bool BANDS_SelectBandRelativeByScanlist(bool next) {
   }
   uint8_t oldScanlistBandIndex = scanlistBandIndex;
   scanlistBandIndex = IncDecU(scanlistBandIndex, 0, gScanlistSize, next);
-  BANDS_Select(gScanlist[scanlistBandIndex], true);
+  BANDS_Select(CHANNELS_ScanlistAt(scanlistBandIndex), true);
   return oldScanlistBandIndex != scanlistBandIndex;
 }
 
@@ -218,10 +289,17 @@ PowerCalibration BANDS_GetPowerCalib(uint32_t f) {
     return b.misc.powCalib;
   }
 
-  for (uint8_t ci = 0; ci < ARRAY_SIZE(POWER_CALIBRATIONS); ++ci) {
-    PCal cal = POWER_CALIBRATIONS[ci];
-    if (cal.s <= f && f < cal.e) {
-      return cal.c;
+  // таблица отсортирована и без пересечений
+  uint8_t lo = 0, hi = ARRAY_SIZE(POWER_CALIBRATIONS);
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    const PCal *cal = &POWER_CALIBRATIONS[mid];
+    if (f < cal->s) {
+      hi = mid;
+    } else if (f >= cal->e) {
+      lo = mid + 1;
+    } else {
+      return cal->c;
     }
   }
 
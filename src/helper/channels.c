@@ -11,13 +11,182 @@
 #include <string.h>
 
 uint16_t gScanlistSize = 0;
-uint16_t gScanlist[SCANLIST_MAX] = {0};
 CHType gScanlistType = TYPE_CH;
 const char *CH_TYPE_NAMES[6] = {"EMPTY", "CH", "BAND", "VFO", "FLD", "SND"};
 const char *TX_POWER_NAMES[4] = {"ULow", "Low", "Mid", "High"};
 const char *TX_OFFSET_NAMES[4] = {"None", "+", "-", "Freq"};
 const char *TX_CODE_TYPES[4] = {"None", "CT", "DCS", "-DCS"};
 
+// 1 = слот свободен (TYPE_EMPTY)
+static uint8_t freeSlots[SCANLIST_MAX / 8];
+static bool indexValid = false; // freeSlots + fIndex
+
+// Обратный индекс: каналы по возрастанию rxF. В RAM только грубый ключ
+// (rxF >> 11, ~20 кГц) и номер слота, точная частота читается из EEPROM
+typedef struct {
+  uint16_t key;
+  uint16_t num;
+} FIndexItem;
+
+static uint16_t fIndexSize;
+static bool fIndexComplete = true; // все каналы влезли
+
+// Несколько последних списков (фильтр, маска), текущий — sl
+#define SL_CACHE_SIZE 4
+
+typedef struct {
+  uint8_t bits[SCANLIST_MAX / 8]; // 1 = слот входит в список
+  uint16_t size;
+  uint16_t mask;
+  uint16_t lastUse;
+  CHTypeFilter filter;
+  bool valid;
+} ScanlistCache;
+
+// Индекс занимает всё, что в chMem остаётся после кэша списков
+#define F_INDEX_MAX                                                            \
+  ((sizeof(uint16_t) * SCANLIST_MAX - sizeof(ScanlistCache) * SL_CACHE_SIZE) / \
+   sizeof(FIndexItem))
+
+// Имена последних запрошенных частот: их спрашивает каждый кадр, а поиск
+// по индексу читает EEPROM. num < 0 - канала нет, f == 0 - пусто
+#define NAME_CACHE_SIZE 8
+
+typedef struct {
+  uint32_t f;
+  int16_t num;
+  char name[10];
+} NameCacheItem;
+
+static NameCacheItem nameCache[NAME_CACHE_SIZE];
+static uint8_t nameCacheNext;
+
+// Индекс по частоте и кэш списков после сортировки всё равно пересобираются,
+// поэтому на время сортировки их память отдаётся под карту перестановки
+// (2 КБ), а не под стек
+static union {
+  struct {
+    FIndexItem fIndex[F_INDEX_MAX];
+    ScanlistCache slCache[SL_CACHE_SIZE];
+  } idx;
+  uint16_t sortMap[SCANLIST_MAX];
+} chMem;
+
+static FIndexItem *const fIndex = chMem.idx.fIndex;
+static ScanlistCache *const slCache = chMem.idx.slCache;
+static ScanlistCache *sl = &chMem.idx.slCache[0];
+static uint16_t *sortMap; // не NULL - идёт сортировка
+static uint16_t slUseCounter;
+
+static inline void setBit(uint8_t *bits, uint16_t num, bool value) {
+  if (value) {
+    bits[num >> 3] |= 1 << (num & 7);
+  } else {
+    bits[num >> 3] &= ~(1 << (num & 7));
+  }
+}
+
+static inline bool getBit(const uint8_t *bits, uint16_t num) {
+  return bits[num >> 3] & (1 << (num & 7));
+}
+
+// Первый установленный бит начиная с from (включительно) вверх или вниз
+static int16_t bitScan(const uint8_t *bits, int16_t from, bool up) {
+  const int16_t max = SCANLIST_MAX;
+  int16_t i = from;
+  while (i >= 0 && i < max) {
+    if (bits[i >> 3] == 0) {
+      // целый байт пуст, прыгаем к соседнему
+      i = up ? (i | 7) + 1 : (i & ~7) - 1;
+      continue;
+    }
+    if (getBit(bits, i)) {
+      return i;
+    }
+    i += up ? 1 : -1;
+  }
+  return -1;
+}
+
+static inline void setSlotFree(uint16_t num, bool isFree) {
+  setBit(freeSlots, num, isFree);
+}
+
+static inline uint16_t fKey(uint32_t f) { return f >> 11; }
+
+static uint16_t fIndexLowerBound(uint16_t key) {
+  uint16_t lo = 0, hi = fIndexSize;
+  while (lo < hi) {
+    uint16_t mid = (lo + hi) / 2;
+    if (fIndex[mid].key < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+static void fIndexRemove(uint16_t num) {
+  for (uint16_t i = 0; i < fIndexSize; ++i) {
+    if (fIndex[i].num == num) {
+      fIndexSize--;
+      memmove(&fIndex[i], &fIndex[i + 1], (fIndexSize - i) * sizeof(fIndex[0]));
+      return;
+    }
+  }
+}
+
+static void fIndexInsert(uint16_t num, uint32_t f) {
+  if (fIndexSize >= F_INDEX_MAX) {
+    fIndexComplete = false;
+    return;
+  }
+  uint16_t key = fKey(f);
+  uint16_t i = fIndexLowerBound(key);
+  memmove(&fIndex[i + 1], &fIndex[i], (fIndexSize - i) * sizeof(fIndex[0]));
+  fIndex[i] = (FIndexItem){.key = key, .num = num};
+  fIndexSize++;
+}
+
+static bool isEmptyToSave(CHTypeFilter filter, CHType type) {
+  return type == TYPE_EMPTY &&
+         (filter == TYPE_FILTER_BAND_SAVE || filter == TYPE_FILTER_CH_SAVE);
+}
+
+static bool isOurType(CHTypeFilter filter, CHType type) {
+  return (filter & (1 << type)) != 0 || isEmptyToSave(filter, type);
+}
+
+static bool isOurScanlist(CHTypeFilter filter, uint16_t mask, CHType type,
+                          uint16_t scanlists) {
+  return mask == SCANLIST_ALL || (scanlists & mask) ||
+         isEmptyToSave(filter, type);
+}
+
+static void invalidateScanlistAt(void);
+
+// Новая запись слота известна целиком, правим списки без чтения EEPROM
+static void updateScanlistCaches(uint16_t num, const CH *p) {
+  for (uint8_t i = 0; i < SL_CACHE_SIZE; ++i) {
+    ScanlistCache *e = &slCache[i];
+    if (!e->valid) {
+      continue;
+    }
+    bool isIn = isOurType(e->filter, p->meta.type) &&
+                isOurScanlist(e->filter, e->mask, p->meta.type, p->scanlists);
+    if (isIn == getBit(e->bits, num)) {
+      continue;
+    }
+    setBit(e->bits, num, isIn);
+    e->size += isIn ? 1 : -1;
+    if (e == sl) {
+      gScanlistSize = e->size;
+      invalidateScanlistAt();
+    }
+  }
+}
+
 static uint32_t getChannelsEnd() {
   uint32_t eepromSize = SETTINGS_GetEEPROMSize();
   uint32_t minSizeWithPatch = CHANNELS_OFFSET + CH_SIZE + PATCH_SIZE;
@@ -36,6 +205,14 @@ uint16_t CHANNELS_GetCountMax(void) {
   return n < SCANLIST_MAX ? n : SCANLIST_MAX;
 }
 
+// Неиспользуемый хвост EEPROM: за последним слотом (их не больше
+// SCANLIST_MAX) и до патча. Возвращает размер, начало - в start
+uint32_t CHANNELS_GetSpareArea(uint32_t *start) {
+  *start = GetChannelOffset(CHANNELS_GetCountMax());
+  uint32_t end = getChannelsEnd();
+  return end > *start ? end - *start : 0;
+}
+
 void CHANNELS_Load(int16_t num, CH *p) {
   if (num >= 0) {
     EEPROM_ReadBuffer(GetChannelOffset(num), p, CH_SIZE);
@@ -49,6 +226,16 @@ void CHANNELS_Save(int16_t num, CH *p) {
     Log(">> W CH%u OFS=%u '%s': f=%u, radio=%u", num, GetChannelOffset(num),
         p->name, p->rxF, p->radio);
     EEPROM_WriteBuffer(GetChannelOffset(num), p, CH_SIZE);
+    setSlotFree(num, p->meta.type == TYPE_EMPTY);
+    memset(nameCache, 0, sizeof(nameCache));
+    if (sortMap) {
+      return; // индексы заняты картой, пересоберутся после сортировки
+    }
+    fIndexRemove(num);
+    if (p->meta.type == TYPE_CH) {
+      fIndexInsert(num, p->rxF);
+    }
+    updateScanlistCaches(num, p);
   }
 }
 
@@ -62,7 +249,110 @@ bool CHANNELS_Existing(int16_t num) {
   if (num < 0 || num >= CHANNELS_GetCountMax()) {
     return false;
   }
-  return CHANNELS_GetMeta(num).type != TYPE_EMPTY;
+  return !CHANNELS_IsFree(num);
+}
+
+static uint32_t readRxF(uint16_t num) {
+  CH ch;
+  EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, name) +
+                        sizeof(ch.name),
+                    (uint8_t *)&ch + offsetof(CH, name) + sizeof(ch.name),
+                    sizeof(uint32_t));
+  return ch.rxF;
+}
+
+// Один проход по EEPROM: свободные слоты и индекс по частоте
+void CHANNELS_LoadIndex() {
+  const uint16_t max = CHANNELS_GetCountMax();
+  memset(freeSlots, 0, sizeof(freeSlots));
+  fIndexSize = 0;
+  fIndexComplete = true;
+  memset(nameCache, 0, sizeof(nameCache));
+  for (uint16_t i = 0; i < max; ++i) {
+    CHType type = CHANNELS_GetMeta(i).type;
+    setSlotFree(i, type == TYPE_EMPTY);
+    if (type == TYPE_CH) {
+      fIndexInsert(i, readRxF(i));
+    }
+  }
+  indexValid = true;
+  Log("CH index: %u, complete=%u", fIndexSize, fIndexComplete);
+}
+
+// EEPROM изменён в обход CHANNELS_Save (UART): индексы перечитаем при
+// обращении, запасные списки выбрасываем
+void CHANNELS_InvalidateCaches() {
+  indexValid = false;
+  for (uint8_t i = 0; i < SL_CACHE_SIZE; ++i) {
+    if (&slCache[i] != sl) {
+      slCache[i].valid = false;
+    }
+  }
+}
+
+bool CHANNELS_IsFree(uint16_t num) {
+  if (!indexValid) {
+    CHANNELS_LoadIndex();
+  }
+  return getBit(freeSlots, num);
+}
+
+// Ищет свободный слот начиная с from (включительно) вверх или вниз
+int16_t CHANNELS_FindFree(int16_t from, bool up) {
+  if (!indexValid) {
+    CHANNELS_LoadIndex();
+  }
+  return bitScan(freeSlots, from, up);
+}
+
+// Канал с rxF == f или -1. Если индекс неполный, промах ничего не значит
+int16_t CHANNELS_FindByF(uint32_t f) {
+  if (!indexValid) {
+    CHANNELS_LoadIndex();
+  }
+  uint16_t key = fKey(f);
+  for (uint16_t i = fIndexLowerBound(key);
+       i < fIndexSize && fIndex[i].key == key; ++i) {
+    if (readRxF(fIndex[i].num) == f) {
+      return fIndex[i].num;
+    }
+  }
+  return -1;
+}
+
+bool CHANNELS_FIndexComplete() { return fIndexComplete; }
+
+// name: 11 байт. Повторный запрос той же частоты шину не трогает
+bool CHANNELS_GetNameByF(uint32_t f, char *name) {
+  if (!indexValid) {
+    CHANNELS_LoadIndex();
+  }
+
+  NameCacheItem *item = NULL;
+  for (uint8_t i = 0; i < NAME_CACHE_SIZE; ++i) {
+    if (nameCache[i].f == f) {
+      item = &nameCache[i];
+      break;
+    }
+  }
+
+  if (!item) {
+    item = &nameCache[nameCacheNext];
+    nameCacheNext = (nameCacheNext + 1) % NAME_CACHE_SIZE;
+    item->f = f;
+    item->num = CHANNELS_FindByF(f);
+    if (item->num >= 0) {
+      EEPROM_ReadBuffer(GetChannelOffset(item->num) + offsetof(CH, name),
+                        item->name, sizeof(item->name));
+    }
+  }
+
+  if (item->num < 0) {
+    return false;
+  }
+  memcpy(name, item->name, sizeof(item->name));
+  name[10] = '\0';
+  return true;
 }
 
 uint16_t CHANNELS_Scanlists(int16_t num) {
@@ -70,15 +360,78 @@ uint16_t CHANNELS_Scanlists(int16_t num) {
   EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, scanlists), &sl, 2);
   return sl;
 }
-static int16_t chScanlistIndex = 0;
+static int16_t chScanlistCH = -1;
+
+// кэш позиции для индексного доступа из UI
+static uint16_t atIndex;
+static int16_t atSlot = -1;
+
+static void invalidateScanlistAt(void) { atSlot = -1; }
+
+bool CHANNELS_InScanlist(uint16_t num) { return getBit(sl->bits, num); }
+
+int16_t CHANNELS_ScanlistNext(int16_t num, bool next) {
+  if (!gScanlistSize) {
+    return -1;
+  }
+  int16_t n = bitScan(sl->bits, num + (next ? 1 : -1), next);
+  if (n < 0) {
+    n = bitScan(sl->bits, next ? 0 : SCANLIST_MAX - 1, next);
+  }
+  return n;
+}
+
+int16_t CHANNELS_ScanlistAt(uint16_t index) {
+  if (index >= gScanlistSize) {
+    return -1;
+  }
+  if (atSlot < 0 || index == 0) {
+    atIndex = 0;
+    atSlot = bitScan(sl->bits, 0, true);
+  }
+  // соседние строки меню — один шаг от кэша
+  while (atIndex < index) {
+    atSlot = bitScan(sl->bits, atSlot + 1, true);
+    atIndex++;
+  }
+  while (atIndex > index) {
+    atSlot = bitScan(sl->bits, atSlot - 1, false);
+    atIndex--;
+  }
+  return atSlot;
+}
+
+int16_t CHANNELS_ScanlistIndexOf(uint16_t num) {
+  if (!CHANNELS_InScanlist(num)) {
+    return -1;
+  }
+  uint16_t index = 0;
+  for (uint16_t i = 0; i < (num >> 3); ++i) {
+    for (uint8_t b = sl->bits[i]; b; b &= b - 1) {
+      index++;
+    }
+  }
+  for (uint16_t i = num & ~7; i < num; ++i) {
+    index += CHANNELS_InScanlist(i);
+  }
+  atIndex = index;
+  atSlot = num;
+  return index;
+}
 
 int16_t CHANNELS_GetCurrentScanlistCH() {
   if (gScanlistSize) {
-    return gScanlist[chScanlistIndex];
+    return chScanlistCH;
   }
   return -1;
 }
 
+void CHANNELS_SetCurrentScanlistCH(int16_t num) {
+  if (num >= 0 && num < SCANLIST_MAX && CHANNELS_InScanlist(num)) {
+    chScanlistCH = num;
+  }
+}
+
 void CHANNELS_LoadCurrentScanlistCH() {
   RADIO_LoadChannelToVFO(gRadioState, RADIO_GetCurrentVFONumber(gRadioState),
                          CHANNELS_GetCurrentScanlistCH());
@@ -89,63 +442,81 @@ void CHANNELS_LoadCurrentScanlistCH() {
 
 void CHANNELS_Next(bool next) {
   if (gScanlistSize) {
-    chScanlistIndex = IncDecU(chScanlistIndex, 0, gScanlistSize, next);
+    chScanlistCH = CHANNELS_ScanlistNext(chScanlistCH, next);
     CHANNELS_LoadCurrentScanlistCH();
   }
 }
 
 void CHANNELS_SetScanlistIndexFromRadio() {
-  if (vfo->mode == MODE_CHANNEL && gScanlistSize) {
-    for (uint16_t i = 0; i < gScanlistSize; ++i) {
-      if (gScanlist[i] == vfo->channel_index) {
-        chScanlistIndex = i;
-        break;
-      }
+  if (vfo->mode == MODE_CHANNEL && gScanlistSize &&
+      CHANNELS_InScanlist(vfo->channel_index)) {
+    chScanlistCH = vfo->channel_index;
+  }
+}
+
+static void buildScanlist(ScanlistCache *e, CHTypeFilter typeFilter,
+                          uint16_t scanlistMask) {
+  Log("Load SL w type_filter=%u", typeFilter);
+  e->filter = typeFilter;
+  e->mask = scanlistMask;
+  e->size = 0;
+  memset(e->bits, 0, sizeof(e->bits));
+  for (uint16_t i = 0; i < CHANNELS_GetCountMax(); ++i) {
+    CHType type = CHANNELS_GetMeta(i).type;
+    if (!isOurType(typeFilter, type)) {
+      continue;
+    }
+
+    bool needScanlists =
+        scanlistMask != SCANLIST_ALL && !isEmptyToSave(typeFilter, type);
+    uint16_t scanlists = needScanlists ? CHANNELS_Scanlists(i) : 0;
+    if (isOurScanlist(typeFilter, scanlistMask, type, scanlists)) {
+      setBit(e->bits, i, true);
+      e->size++;
+      // Log("Load CH %u in SL", i);
     }
   }
+  e->valid = true;
+  Log("SL sz: %u", e->size);
 }
 
-static CHTypeFilter _typeFilter = TYPE_FILTER_BAND_SAVE;
-static uint16_t _scanlistMask = UINT16_MAX;
 void CHANNELS_LoadScanlist(CHTypeFilter typeFilter, uint16_t scanlistMask) {
-  if (_typeFilter == typeFilter && _scanlistMask == scanlistMask) {
+  if (sl->valid && sl->filter == typeFilter && sl->mask == scanlistMask) {
     return;
   }
-  _typeFilter = typeFilter;
-  _scanlistMask = scanlistMask;
 
-  Log("Load SL w type_filter=%u", typeFilter);
   if (gSettings.currentScanlist != scanlistMask) {
     gSettings.currentScanlist = scanlistMask;
     SETTINGS_Save();
   }
-  gScanlistSize = 0;
-  for (uint16_t i = 0; i < CHANNELS_GetCountMax(); ++i) {
-    CHMeta meta = CHANNELS_GetMeta(i);
-    bool isSaveFilter = typeFilter == TYPE_FILTER_BAND_SAVE ||
-                        typeFilter == TYPE_FILTER_CH_SAVE;
-    bool isEmptyChannelToSave = meta.type == TYPE_EMPTY && isSaveFilter;
-
-    bool isOurType =
-        (typeFilter & (1 << meta.type)) != 0 || isEmptyChannelToSave;
-    if (!isOurType) {
-      continue;
-    }
 
-    bool isOurScanlist = (isOurType && scanlistMask == SCANLIST_ALL) ||
-                         (CHANNELS_Scanlists(i) & scanlistMask) ||
-                         isEmptyChannelToSave;
-    if (isOurScanlist) {
-      gScanlist[gScanlistSize] = i;
-      gScanlistSize++;
-      // Log("Load CH %u in SL", i);
+  ScanlistCache *e = NULL;
+  ScanlistCache *victim = &slCache[0];
+  for (uint8_t i = 0; i < SL_CACHE_SIZE; ++i) {
+    ScanlistCache *c = &slCache[i];
+    if (c->valid && c->filter == typeFilter && c->mask == scanlistMask) {
+      e = c;
+      break;
     }
+    // свободный или самый давний
+    if (victim->valid && (!c->valid || c->lastUse < victim->lastUse)) {
+      victim = c;
+    }
+  }
+  if (!e) {
+    e = victim;
+    buildScanlist(e, typeFilter, scanlistMask);
   }
+
+  e->lastUse = ++slUseCounter;
+  sl = e;
+  gScanlistSize = e->size;
+  invalidateScanlistAt();
+
   if (typeFilter == TYPE_FILTER_CH || typeFilter == TYPE_FILTER_CH_SAVE) {
-    chScanlistIndex = 0;
+    chScanlistCH = CHANNELS_ScanlistAt(0);
     CHANNELS_SetScanlistIndexFromRadio();
   }
-  Log("SL sz: %u", gScanlistSize);
 }
 
 void CHANNELS_LoadBlacklistToLoot() {
@@ -163,6 +534,357 @@ void CHANNELS_LoadBlacklistToLoot() {
   }
 }
 
+// Сортировка и уплотнение таблицы каналов.
+// Участвуют только слоты TYPE_CH и TYPE_EMPTY, остальные типы не двигаются.
+// Карта перестановки живёт в chMem на месте индексов:
+// map[slot] = слот, откуда взять запись для slot (или SLOT_NONE).
+#define SLOT_MASK 0x1FFF
+#define SLOT_NONE SLOT_MASK
+#define SLOT_OCCUPIED (1 << 13) // сейчас в слоте есть запись
+#define SLOT_SOURCE (1 << 14)   // запись слота нужна в другом слоте
+#define SLOT_DONE (1 << 15)
+
+typedef struct {
+  char name[10];
+  uint32_t f;
+} SortKey;
+
+static void loadSortKey(uint16_t num, SortKey *key) {
+  CH ch;
+  // name и rxF лежат подряд, читаем только их
+  EEPROM_ReadBuffer(GetChannelOffset(num) + offsetof(CH, name),
+                    (uint8_t *)&ch + offsetof(CH, name),
+                    sizeof(ch.name) + sizeof(uint32_t));
+  memcpy(key->name, ch.name, sizeof(key->name));
+  key->f = ch.rxF;
+}
+
+static int cmpSortKeys(const SortKey *a, const SortKey *b, CHSortOrder order) {
+  int byName = strncmp(a->name, b->name, sizeof(a->name));
+  int byF = (a->f > b->f) - (a->f < b->f);
+  if (order == CH_SORT_NAME) {
+    return byName ? byName : byF;
+  }
+  return byF ? byF : byName;
+}
+
+// Бинарная вставка в sortMap[0..n), возвращает новый размер.
+// Равные ключи сохраняют порядок слотов
+static uint16_t sortedInsert(uint16_t n, uint16_t slot, CHSortOrder order) {
+  SortKey key, k;
+  loadSortKey(slot, &key);
+
+  uint16_t lo = 0, hi = n;
+  while (lo < hi) {
+    uint16_t mid = (lo + hi) / 2;
+    loadSortKey(sortMap[mid], &k);
+    if (cmpSortKeys(&k, &key, order) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  memmove(&sortMap[lo + 1], &sortMap[lo], (n - lo) * sizeof(sortMap[0]));
+  sortMap[lo] = slot;
+  return n + 1;
+}
+
+static inline uint16_t mapFrom(uint16_t slot) {
+  return sortMap[slot] & SLOT_MASK;
+}
+
+// Журнал сортировки: пустой слот (тип TYPE_EMPTY, для остальных он свободен),
+// в имени - метка и перенос, начатый последним. Слот в перестановку не
+// входит, поэтому находится по метке и после сбоя питания
+#define SORT_MAGIC "CHSRT"
+
+typedef struct {
+  char magic[6];
+  uint16_t from; // SLOT_NONE - переносов ещё не было
+  uint16_t to;
+} __attribute__((packed)) SortJournal;
+
+static int16_t journalSlot = -1;
+static uint16_t vfoSlots[MAX_VFOS];
+static uint16_t vfoChannels[MAX_VFOS];
+static uint8_t vfoCount;
+
+static uint32_t journalOffset(void) {
+  return GetChannelOffset(journalSlot) + offsetof(CH, name);
+}
+
+static void journalWrite(uint16_t from, uint16_t to) {
+  uint16_t v[2] = {from, to};
+  EEPROM_WriteBuffer(journalOffset() + offsetof(SortJournal, from),
+                     (uint8_t *)v, sizeof(v));
+}
+
+static bool journalRead(uint16_t slot, SortJournal *j) {
+  EEPROM_ReadBuffer(GetChannelOffset(slot) + offsetof(CH, name), j,
+                    sizeof(*j));
+  return !memcmp(j->magic, SORT_MAGIC, sizeof(j->magic));
+}
+
+static void journalCreate(void) {
+  SortJournal j = {SORT_MAGIC, SLOT_NONE, SLOT_NONE};
+  EEPROM_WriteBuffer(journalOffset(), (uint8_t *)&j, sizeof(j));
+}
+
+// Ссылки VFO переводятся сразу после каждого переноса, а не в конце:
+// прерванная сортировка не оставляет VFO на чужой записи
+static void remapVFOs(uint16_t from, uint16_t to) {
+  for (uint8_t i = 0; i < vfoCount; ++i) {
+    if (vfoChannels[i] != from) {
+      continue;
+    }
+    VFO v;
+    CHANNELS_Load(vfoSlots[i], &v);
+    v.channel = to;
+    CHANNELS_Save(vfoSlots[i], &v);
+    vfoChannels[i] = to;
+  }
+
+  if (!gRadioState) {
+    return;
+  }
+  for (uint8_t i = 0; i < gRadioState->num_vfos; ++i) {
+    ExtendedVFOContext *v = &gRadioState->vfos[i];
+    if (v->channel_index == from) {
+      v->channel_index = to;
+    }
+  }
+}
+
+// Журнал пишется до копии, VFO - после неё
+static void moveRecord(uint16_t from, uint16_t to) {
+  CH ch;
+  journalWrite(from, to);
+  CHANNELS_Load(from, &ch);
+  CHANNELS_Save(to, &ch);
+  remapVFOs(from, to);
+}
+
+static bool sameRecord(uint16_t a, uint16_t b) {
+  CH ca, cb;
+  CHANNELS_Load(a, &ca);
+  CHANNELS_Load(b, &cb);
+  return !memcmp(&ca, &cb, sizeof(ca));
+}
+
+// Доводит перенос, на котором оборвалась прошлая сортировка. Приёмник к
+// началу переноса уже не нужен (его запись перенесена раньше), поэтому:
+// копия совпала - лишний уже источник, нет - приёмник; пустой источник -
+// перенос закончен и подчищен
+static void journalRecover(const SortJournal *j, uint16_t max) {
+  if (j->from >= max || j->to >= max || j->from == j->to ||
+      CHANNELS_GetMeta(j->from).type == TYPE_EMPTY) {
+    return;
+  }
+  if (sameRecord(j->from, j->to)) {
+    CHANNELS_Delete(j->from);
+    remapVFOs(j->from, j->to);
+  } else {
+    CHANNELS_Delete(j->to);
+  }
+}
+
+// Применяет перестановку: каждая перемещаемая запись пишется ровно один раз
+// (первая запись цикла - дважды, через свободный слот), слоты, которые не
+// меняются, не перезаписываются. Запись всегда существует хотя бы в одной
+// копии, а лишнюю копию после сбоя питания убирает journalRecover.
+static uint16_t applySortMap(uint16_t max) {
+  uint16_t *map = sortMap;
+  uint16_t written = 0;
+
+  for (uint16_t slot = 0; slot < max; ++slot) {
+    uint16_t from = mapFrom(slot);
+    if (from != SLOT_NONE && from != slot) {
+      map[from] |= SLOT_SOURCE;
+    }
+  }
+
+  // цепочки: начинаются в слоте, чьё содержимое никому не нужно,
+  // на каждом шаге запись существует хотя бы в одной копии
+  for (uint16_t d = 0; d < max; ++d) {
+    if ((map[d] & (SLOT_DONE | SLOT_SOURCE)) || mapFrom(d) == d) {
+      continue;
+    }
+    for (uint16_t cur = d;;) {
+      uint16_t from = mapFrom(cur);
+      map[cur] |= SLOT_DONE;
+      if (from == SLOT_NONE) {
+        if (map[cur] & SLOT_OCCUPIED) {
+          CHANNELS_Delete(cur);
+          written++;
+        }
+        break;
+      }
+      moveRecord(from, cur);
+      written++;
+      cur = from;
+    }
+  }
+
+  // остались только циклы. Первая запись уходит в свободный слот, который
+  // в итоге остаётся пустым, и возвращается оттуда в конец цикла
+  int16_t scratch = -1;
+  for (uint16_t d = 0; d < max; ++d) {
+    if (mapFrom(d) == SLOT_NONE) {
+      scratch = d;
+      break;
+    }
+  }
+
+  for (uint16_t d = 0; d < max && scratch >= 0; ++d) {
+    if ((map[d] & SLOT_DONE) || mapFrom(d) == d) {
+      continue;
+    }
+    moveRecord(d, scratch);
+    written++;
+    for (uint16_t cur = d;;) {
+      uint16_t from = mapFrom(cur);
+      map[cur] |= SLOT_DONE;
+      if (from == d) {
+        from = scratch;
+      }
+      moveRecord(from, cur);
+      written++;
+      if (from == scratch) {
+        break;
+      }
+      cur = from;
+    }
+    CHANNELS_Delete(scratch);
+    written++;
+  }
+
+  return written;
+}
+
+static void setPendingSort(CHSortOrder order) {
+  gSettings.chSortOrder = order;
+  gSettings.chSortCheck = order == CH_SORT_NONE ? 0 : order ^ 3;
+  SETTINGS_Save();
+}
+
+// Прерванная сортировка из настроек. Поле раньше было резервным, поэтому
+// порядок без парного chSortCheck считается мусором и сбрасывается
+CHSortOrder CHANNELS_PendingSort(void) {
+  const CHSortOrder order = gSettings.chSortOrder;
+  if ((order == CH_SORT_F || order == CH_SORT_NAME) &&
+      gSettings.chSortCheck == (order ^ 3)) {
+    return order;
+  }
+  if (order != CH_SORT_NONE || gSettings.chSortCheck) {
+    setPendingSort(CH_SORT_NONE);
+  }
+  return CH_SORT_NONE;
+}
+
+static void endSort(void) {
+  sortMap = NULL;
+  journalSlot = -1;
+  memset(&chMem, 0, sizeof(chMem));
+  indexValid = false;
+  sl = &slCache[0];
+  gScanlistSize = 0;
+  invalidateScanlistAt();
+}
+
+// Журнал от прерванной сортировки или последний пустой слот под новый,
+// заодно ссылки всех VFO
+static bool findJournal(uint16_t max, SortJournal *j) {
+  bool found = false;
+  journalSlot = -1;
+  vfoCount = 0;
+  for (uint16_t i = 0; i < max; ++i) {
+    CHType type = CHANNELS_GetMeta(i).type;
+    if (type == TYPE_VFO && vfoCount < MAX_VFOS) {
+      VFO v;
+      CHANNELS_Load(i, &v);
+      vfoSlots[vfoCount] = i;
+      vfoChannels[vfoCount++] = v.channel;
+    } else if (type == TYPE_EMPTY && !found) {
+      found = journalRead(i, j);
+      journalSlot = i;
+    }
+  }
+  return found;
+}
+
+// false, если в таблице меньше двух свободных слотов: один занимает журнал,
+// без второго циклы перестановки не переносятся без риска потерять запись
+bool CHANNELS_Sort(CHSortOrder order) {
+  const uint16_t max = CHANNELS_GetCountMax();
+  uint16_t *map = chMem.sortMap;
+  uint16_t n = 0;
+  uint16_t domainSize = 0;
+  SortJournal journal;
+
+  sortMap = map;
+
+  const bool resumed = findJournal(max, &journal);
+  if (resumed) {
+    Log("Sort CH: resume at %u -> %u", journal.from, journal.to);
+    journalRecover(&journal, max);
+    journalWrite(SLOT_NONE, SLOT_NONE);
+  }
+
+  for (uint16_t i = 0; i < max; ++i) {
+    CHType type = CHANNELS_GetMeta(i).type;
+    if (i == journalSlot || (type != TYPE_CH && type != TYPE_EMPTY)) {
+      continue;
+    }
+    if (type == TYPE_CH) {
+      n = sortedInsert(n, i, order);
+    }
+    domainSize++;
+  }
+  Log("Sort CH: %u of %u", n, domainSize);
+
+  if (journalSlot < 0 || n >= domainSize) {
+    if (resumed) {
+      CHANNELS_Delete(journalSlot);
+    }
+    endSort();
+    setPendingSort(CH_SORT_NONE);
+    Log("Sort CH: need 2 free slots");
+    return false;
+  }
+
+  // флаг в настройках: при сбое питания сортировка продолжится при загрузке
+  if (gSettings.chSortOrder != order) {
+    setPendingSort(order);
+  }
+  if (!resumed) {
+    journalCreate();
+  }
+
+  // порядок (индекс -> слот) в карту (слот -> откуда), на месте:
+  // i-й слот домена всегда >= i, поэтому идём с конца
+  for (uint16_t slot = max; slot--;) {
+    CHType type = CHANNELS_GetMeta(slot).type;
+    if (slot == journalSlot || (type != TYPE_CH && type != TYPE_EMPTY)) {
+      map[slot] = slot;
+      continue;
+    }
+    domainSize--;
+    uint16_t from = domainSize < n ? map[domainSize] : SLOT_NONE;
+    map[slot] = from | (type == TYPE_CH ? SLOT_OCCUPIED : 0);
+  }
+
+  uint16_t written = applySortMap(max);
+  CHANNELS_Delete(journalSlot);
+
+  // слоты переехали: индекс и все списки перечитать при следующем обращении
+  endSort();
+
+  setPendingSort(CH_SORT_NONE);
+  Log("Sort CH: %u written", written);
+  return true;
+}
+
 uint16_t CHANNELS_GetStepSize(CH *p) { return StepFrequencyTable[p->step]; }
 
 uint32_t CHANNELS_GetSteps(CH *p) {
@@ -51,6 +51,12 @@ typedef enum {
   TYPE_FILTER_VFO_SAVE = (1 << TYPE_VFO) | (1 << TYPE_EMPTY),
 } CHTypeFilter;
 
+typedef enum {
+  CH_SORT_NONE,
+  CH_SORT_F,
+  CH_SORT_NAME,
+} CHSortOrder;
+
 typedef enum {
   STEP_0_02kHz,
   STEP_0_05kHz,
@@ -159,18 +165,33 @@ typedef MR VFO;
 typedef MR CH;
 
 uint16_t CHANNELS_GetCountMax();
+uint32_t CHANNELS_GetSpareArea(uint32_t *start);
 
 void CHANNELS_Load(int16_t num, CH *p);
 void CHANNELS_Save(int16_t num, CH *p);
 bool CHANNELS_LoadBuf();
 int16_t CHANNELS_GetCurrentScanlistCH();
+void CHANNELS_SetCurrentScanlistCH(int16_t num);
 void CHANNELS_Next(bool next);
 void CHANNELS_Delete(int16_t i);
 bool CHANNELS_Existing(int16_t i);
+void CHANNELS_LoadIndex();
+void CHANNELS_InvalidateCaches();
+bool CHANNELS_IsFree(uint16_t num);
+int16_t CHANNELS_FindFree(int16_t from, bool up);
+int16_t CHANNELS_FindByF(uint32_t f);
+bool CHANNELS_FIndexComplete();
+bool CHANNELS_GetNameByF(uint32_t f, char *name);
 uint16_t CHANNELS_Scanlists(int16_t i);
 void CHANNELS_LoadScanlist(CHTypeFilter type, uint16_t n);
+bool CHANNELS_InScanlist(uint16_t num);
+int16_t CHANNELS_ScanlistNext(int16_t num, bool next);
+int16_t CHANNELS_ScanlistAt(uint16_t index);
+int16_t CHANNELS_ScanlistIndexOf(uint16_t num);
 void CHANNELS_LoadBlacklistToLoot();
 void CHANNELS_LoadCurrentScanlistCH();
+bool CHANNELS_Sort(CHSortOrder order);
+CHSortOrder CHANNELS_PendingSort(void);
 
 void CHANNELS_SetScanlistIndexFromRadio();
 
@@ -186,7 +207,6 @@ uint16_t CHANNELS_ScanlistByKey(uint16_t sl, KEY_Code_t key, bool longPress);
 void CHANNELS_SelectScanlistByKey(KEY_Code_t key, bool longPress);
 
 extern uint16_t gScanlistSize;
-extern uint16_t gScanlist[SCANLIST_MAX];
 extern const char *TX_POWER_NAMES[4];
 extern const char *TX_OFFSET_NAMES[4];
 extern const char *TX_CODE_TYPES[4];
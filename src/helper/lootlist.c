@@ -4,6 +4,7 @@
 #include "../external/printf/printf.h"
 #include "../radio.h"
 #include "../scheduler.h"
+#include "../ui/widgets.h"
 #include "bands.h"
 #include <stdint.h>
 
@@ -18,6 +19,7 @@ void LOOT_BlacklistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->whitelist = false;
     gLastActiveLoot->blacklist = true;
+    UI_Invalidate(WIDGET_LOOT);
   }
 }
 
@@ -25,6 +27,7 @@ void LOOT_WhitelistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->blacklist = false;
     gLastActiveLoot->whitelist = true;
+    UI_Invalidate(WIDGET_LOOT);
   }
 }
 
@@ -161,6 +164,9 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
 
   if (item->open) {
     item->duration += Now() - lastTimeCheck;
+    if (gLastActiveLoot != item) {
+      UI_Invalidate(WIDGET_LOOT);
+    }
     gLastActiveLoot = item;
     gLastActiveLootIndex = LOOT_IndexOf(item);
   }
@@ -188,6 +194,9 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
     item->lastTimeOpen = Now();
   }
   lastTimeCheck = Now();
+  if (item == gLastActiveLoot && item->open != msm->open) {
+    UI_Invalidate(WIDGET_LOOT);
+  }
   item->open = msm->open;
   msm->ct = item->ct;
   msm->cd = item->cd;
@@ -79,14 +79,21 @@ uint16_t Mean(const uint16_t *array, size_t n) {
   return sum / n;
 }
 
+// Поразрядный целый корень: 16 итераций вместо перебора до sqrt(v)
 uint16_t Sqrt(uint32_t v) {
-  uint16_t res = 0;
-  for (uint32_t i = 0; i < v; ++i) {
-    if (i * i <= v) {
-      res = i;
+  uint32_t res = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v) {
+    bit >>= 2;
+  }
+  while (bit) {
+    if (v >= res + bit) {
+      v -= res + bit;
+      res = (res >> 1) + bit;
     } else {
-      break;
+      res >>= 1;
     }
+    bit >>= 2;
   }
   return res;
 }
@@ -35,6 +35,7 @@ uint16_t Mid(const uint16_t *array, size_t n);
 uint16_t Min(const uint16_t *array, size_t n);
 uint16_t Max(const uint16_t *array, size_t n);
 uint16_t Mean(const uint16_t *array, size_t n);
+uint16_t Sqrt(uint32_t v);
 uint16_t Std(const uint16_t *data, size_t n);
 
 uint32_t AdjustU(uint32_t val, uint32_t min, uint32_t max, int32_t inc);
@@ -78,18 +78,46 @@ void MENU_Init(Menu *main_menu) {
 
 void MENU_Deinit() { active_menu = NULL; }
 
+static uint16_t getOffset(void) {
+  return (active_menu->i >= 2) ? active_menu->i - 2 : 0;
+}
+
+static void renderRow(uint16_t idx, uint16_t offset) {
+  const uint8_t y = active_menu->y + (idx - offset) * active_menu->itemHeight;
+
+  active_menu->render_item(idx, idx - offset);
+
+  if (idx == active_menu->i) {
+    FillRect(active_menu->x, y, getMenuRightEdge() - 4,
+             active_menu->itemHeight, C_INVERT);
+  }
+}
+
+static void renderScrollbar(void) {
+  const uint8_t ex = getMenuRightEdge();
+  const uint8_t ey = active_menu->y + active_menu->height;
+  const uint8_t y = ConvertDomain(active_menu->i, 0, active_menu->num_items - 1,
+                                  active_menu->y, ey - 3);
+
+  DrawVLine(ex - 2, active_menu->y, active_menu->height, C_FILL);
+
+  FillRect(ex - 3, y, 3, 3, C_FILL);
+}
+
+// Что нарисовано последним: по этому MENU_Update решает, хватит ли строк
+static const Menu *drawnMenu;
+static uint16_t drawnIndex;
+static uint16_t drawnOffset;
+
 void MENU_Render(void) {
   if (!active_menu)
     return;
 
   uint8_t itemsShow = active_menu->height / active_menu->itemHeight;
 
-  const uint16_t offset = (active_menu->i >= 2) ? active_menu->i - 2 : 0;
+  const uint16_t offset = getOffset();
   const uint16_t visible = MIN(active_menu->num_items, itemsShow);
 
-  const uint8_t ex = getMenuRightEdge();
-  const uint8_t ey = active_menu->y + active_menu->height;
-
   FillRect(active_menu->x, active_menu->y, active_menu->width,
            active_menu->height, C_CLEAR);
 
@@ -98,25 +126,51 @@ void MENU_Render(void) {
     if (idx >= active_menu->num_items)
       break;
 
-    const bool isActive = idx == active_menu->i;
-    const uint8_t y = active_menu->y + i * active_menu->itemHeight;
+    renderRow(idx, offset);
+  }
 
-    active_menu->render_item(idx, i);
+  renderScrollbar();
 
-    if (isActive) {
-      FillRect(active_menu->x, y, ex - 4, active_menu->itemHeight, C_INVERT);
-    }
+  drawnMenu = active_menu;
+  drawnIndex = active_menu->i;
+  drawnOffset = offset;
+}
+
+// Список не сдвинулся - перерисовываем только прежнюю и новую строку
+// выбора и полосу прокрутки, иначе меню целиком
+void MENU_Update(void) {
+  if (!active_menu)
+    return;
+
+  const uint16_t offset = getOffset();
+  if (drawnMenu != active_menu || offset != drawnOffset ||
+      drawnIndex >= active_menu->num_items) {
+    MENU_Render();
+    return;
   }
 
-  // scrollbar
-  const uint8_t y = ConvertDomain(active_menu->i, 0, active_menu->num_items - 1,
-                                  active_menu->y, ey - 3);
+  const uint8_t ex = getMenuRightEdge();
+  const uint8_t h = active_menu->itemHeight;
+  const uint16_t rows[2] = {drawnIndex, active_menu->i};
 
-  DrawVLine(ex - 2, active_menu->y, active_menu->height, C_FILL);
+  for (uint8_t r = 0; r < 2; ++r) {
+    if (r && rows[1] == rows[0])
+      break;
+    FillRect(active_menu->x, active_menu->y + (rows[r] - offset) * h, ex - 4,
+             h, C_CLEAR);
+    renderRow(rows[r], offset);
+  }
 
-  FillRect(ex - 3, y, 3, 3, C_FILL);
+  FillRect(ex - 3, active_menu->y, 3, active_menu->height, C_CLEAR);
+  renderScrollbar();
+
+  drawnIndex = active_menu->i;
 }
 
+const Widget MENU_WIDGETS[MENU_WIDGETS_COUNT] = {
+    {WIDGET_MENU, MENU_Y, LCD_HEIGHT - MENU_Y, MENU_Render, MENU_Update},
+};
+
 static void setMenuIndex(uint16_t i) { active_menu->i = i - 1; }
 
 static bool handleNumNav(KEY_Code_t key, Key_State_t state) {
@@ -148,6 +202,7 @@ static bool handleUpDownNavigation(KEY_Code_t key, bool hasItems) {
 
   active_menu->i =
       IncDecU(active_menu->i, 0, active_menu->num_items, key == KEY_DOWN);
+  UI_Invalidate(WIDGET_MENU);
 
   if (!hasItems && active_menu->action) {
     active_menu->action(active_menu->i, key, KEY_RELEASED);
@@ -193,6 +248,7 @@ bool MENU_HandleInput(KEY_Code_t key, Key_State_t state) {
     if (key == KEY_STAR || key == KEY_F) {
       if (item->change_value) {
         item->change_value(item, key == KEY_STAR);
+        UI_Invalidate(WIDGET_MENU);
         return true;
       }
       return true;
@@ -3,6 +3,7 @@
 #define MENU_H
 
 #include "../driver/keyboard.h"
+#include "../ui/widgets.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -44,8 +45,13 @@ typedef struct Menu {
 void MENU_Init(Menu *main_menu);
 void MENU_Deinit();
 void MENU_Render(void);
+void MENU_Update(void);
 bool MENU_HandleInput(KEY_Code_t key, Key_State_t state);
 bool MENU_Back(void);
 bool MENU_IsActive();
 
+// Приложение, у которого на экране только меню, отдаёт его строки областью
+#define MENU_WIDGETS_COUNT 1
+extern const Widget MENU_WIDGETS[MENU_WIDGETS_COUNT];
+
 #endif /* end of include guard: MENU_H */
@@ -0,0 +1,64 @@
+#include "profile.h"
+#include "../driver/systick.h"
+#include <string.h>
+
+const char *PROF_NAMES[PROF_COUNT] = {
+    [PROF_SETTINGS] = "SET",  [PROF_SCAN] = "SCAN", [PROF_APPS] = "APP",
+    [PROF_KEYS] = "KEY",      [PROF_SYSTEM] = "SYS", [PROF_RENDER] = "DRAW",
+    [PROF_UART] = "UART",     [PROF_LOOP] = "LOOP",
+};
+
+static ProfStat stats[PROF_COUNT];
+
+static uint8_t bucketOf(uint32_t us) {
+  uint8_t b = us ? 32 - __builtin_clz(us) : 0;
+  return b < PROF_BUCKETS ? b : PROF_BUCKETS - 1;
+}
+
+void PROF_Add(ProfStage stage, uint32_t us) {
+  ProfStat *s = &stats[stage];
+  uint8_t b = bucketOf(us);
+
+  s->count++;
+  if (us > s->max) {
+    s->max = us;
+  }
+
+  // Байтовые счётчики: форма распределения важнее абсолютных чисел
+  if (s->hist[b] == UINT8_MAX) {
+    for (uint8_t i = 0; i < PROF_BUCKETS; ++i) {
+      s->hist[i] >>= 1;
+    }
+  }
+  s->hist[b]++;
+}
+
+// Добавляет время с since, возвращает текущий момент для следующего этапа
+uint32_t PROF_Mark(ProfStage stage, uint32_t since) {
+  uint32_t now = GetUptimeUs();
+  PROF_Add(stage, now - since);
+  return now;
+}
+
+const ProfStat *PROF_Get(ProfStage stage) { return &stats[stage]; }
+
+// Верхняя граница корзины, мкс
+uint32_t PROF_BucketUs(uint8_t bucket) { return 1UL << bucket; }
+
+uint8_t PROF_Median(ProfStage stage) {
+  const ProfStat *s = &stats[stage];
+  uint16_t total = 0, acc = 0;
+
+  for (uint8_t i = 0; i < PROF_BUCKETS; ++i) {
+    total += s->hist[i];
+  }
+  for (uint8_t i = 0; i < PROF_BUCKETS; ++i) {
+    acc += s->hist[i];
+    if (acc * 2 >= total) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+void PROF_Reset(void) { memset(stats, 0, sizeof(stats)); }
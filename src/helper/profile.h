@@ -0,0 +1,37 @@
+#ifndef PROFILE_HELPER_H
+#define PROFILE_HELPER_H
+
+#include <stdint.h>
+
+// Этапы главного цикла SYS_Main
+typedef enum {
+  PROF_SETTINGS,
+  PROF_SCAN,
+  PROF_APPS,
+  PROF_KEYS,
+  PROF_SYSTEM,
+  PROF_RENDER,
+  PROF_UART,
+  PROF_LOOP,
+  PROF_COUNT,
+} ProfStage;
+
+// Корзина i: длительность в [2^(i-1), 2^i) мкс, последняя - всё длиннее
+#define PROF_BUCKETS 16
+
+typedef struct {
+  uint32_t count;
+  uint32_t max;                  // мкс, худший случай
+  uint8_t hist[PROF_BUCKETS];    // при насыщении делится пополам целиком
+} ProfStat;
+
+extern const char *PROF_NAMES[PROF_COUNT];
+
+void PROF_Add(ProfStage stage, uint32_t us);
+uint32_t PROF_Mark(ProfStage stage, uint32_t since);
+const ProfStat *PROF_Get(ProfStage stage);
+uint32_t PROF_BucketUs(uint8_t bucket);
+uint8_t PROF_Median(ProfStage stage);
+void PROF_Reset(void);
+
+#endif /* end of include guard: PROFILE_HELPER_H */
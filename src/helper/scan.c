@@ -7,9 +7,13 @@
 #include "../radio.h"
 #include "../scheduler.h"
 #include "../ui/spectrum.h"
+#include "../ui/widgets.h"
 #include "bands.h"
 #include "channels.h"
 #include "lootlist.h"
+#include "stream.h"
+#include "trace.h"
+#include <string.h>
 
 // =============================
 // Состояние сканирования
@@ -31,6 +35,38 @@ typedef struct {
   bool isMultiband;        // Мультидиапазонный режим
 } ScanState;
 
+// Рабочий набор канального сканирования: только то, что нужно для прыжка.
+// Полная запись MR читается, только когда скан остановился на канале.
+// Настройки приёма у каналов списка почти всегда повторяются, поэтому на
+// канал хранится частота и номер профиля, а сами профили - в общей таблице.
+// Номер слота не хранится: рабочий набор идёт в порядке списка
+#define SCAN_CH_MAX 128
+#define SCAN_PROFILE_MAX 32
+
+typedef struct {
+  uint8_t gain : 5;
+  uint8_t sqValue : 4;
+  Radio radio : 2;
+  ModulationType modulation : 4;
+  BK4819_FilterBandwidth_t bw : 4;
+  SquelchType sqType : 2;
+  uint8_t codeType : 2;
+  uint8_t codeValue : 8;
+} __attribute__((packed)) ScanProfile;
+
+typedef struct {
+  uint32_t f : 27;
+  uint8_t profile : 5;
+} __attribute__((packed)) ScanCH;
+
+static ScanCH scanCh[SCAN_CH_MAX];
+static ScanProfile scanProfiles[SCAN_PROFILE_MAX];
+static uint8_t scanProfileCount;
+static uint16_t scanChCount;
+static uint16_t scanChIndex;
+static uint8_t scanProfileApplied; // какой профиль сейчас стоит в ctx
+static bool scanChFull;            // полная запись загружена
+
 static ScanState scan = {
     .mode = SCAN_MODE_SINGLE,
     .scanDelayUs = 1200,
@@ -65,14 +101,29 @@ static void UpdateCPS() {
   }
 }
 
-static uint16_t MeasureSignal(uint32_t frequency, bool precise) {
+static uint16_t MeasureSignalDwell(uint32_t frequency, bool precise,
+                                   uint32_t dwellUs) {
   RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, precise, false);
   RADIO_SetParam(ctx, PARAM_FREQUENCY, frequency, false);
   RADIO_ApplySettings(ctx);
-  TIMER_DelayUs(precise ? scan.scanDelayUs : 50);
+  TIMER_DelayUs(dwellUs);
   return RADIO_GetRSSI(ctx);
 }
 
+static uint16_t MeasureSignal(uint32_t frequency, bool precise) {
+  return MeasureSignalDwell(frequency, precise,
+                            precise ? scan.scanDelayUs : 50);
+}
+
+// Точка в спектр и, для развёртки по частоте, в UART-поток
+static void AddPoint() {
+  SP_AddPoint(&vfo->msm);
+  if (scan.mode != SCAN_MODE_CHANNEL) {
+    STREAM_AddPoint(&vfo->msm,
+                    StepFrequencyTable[RADIO_GetParam(ctx, PARAM_STEP)]);
+  }
+}
+
 static void ApplyBandSettings() {
   vfo->msm.f = gCurrentBand.rxF;
 
@@ -80,8 +131,7 @@ static void ApplyBandSettings() {
   RADIO_SetParam(ctx, PARAM_STEP, gCurrentBand.step, false);
   RADIO_ApplySettings(ctx);
   SP_Init(&gCurrentBand);
-  LogC(LOG_C_BRIGHT_YELLOW, "[SCANER] Bounds: %u .. %u", gCurrentBand.rxF,
-       gCurrentBand.txF);
+  TRACE(TR_SCAN_BAND, 0, gCurrentBand.rxF, gCurrentBand.txF);
   if (gLastActiveLoot && !BANDS_InRange(gLastActiveLoot->f, gCurrentBand)) {
     gLastActiveLoot = NULL;
   }
@@ -100,12 +150,16 @@ static void NextFrequency() {
     if (scan.isMultiband) {
       BANDS_SelectBandRelativeByScanlist(true);
       ApplyBandSettings();
+      // другие границы диапазона, спектр и водопад начаты заново
+      UI_Invalidate(WIDGET_SPECTRUM | WIDGET_FREQ | WIDGET_WATERFALL);
     }
+    SP_EndSweep();
     vfo->msm.f = gCurrentBand.rxF;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_SPECTRUM);
   } else if (vfo->msm.f < gCurrentBand.rxF) {
+    SP_EndSweep();
     vfo->msm.f = gCurrentBand.txF;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_SPECTRUM);
   }
 
   LOOT_Replace(&vfo->msm, vfo->msm.f);
@@ -114,6 +168,117 @@ static void NextFrequency() {
   UpdateCPS();
 }
 
+// Номер профиля, новый профиль добавляется в таблицу; -1 - таблица полна
+static int8_t FindScanProfile(const CH *ch) {
+  ScanProfile p;
+  memset(&p, 0, sizeof(p));
+  p.gain = ch->gainIndex;
+  p.sqValue = ch->squelch.value;
+  p.radio = ch->radio;
+  p.modulation = ch->modulation;
+  p.bw = ch->bw;
+  p.sqType = ch->squelch.type;
+  p.codeType = ch->code.rx.type;
+  p.codeValue = ch->code.rx.value;
+
+  for (uint8_t i = 0; i < scanProfileCount; ++i) {
+    if (!memcmp(&scanProfiles[i], &p, sizeof(p))) {
+      return i;
+    }
+  }
+  if (scanProfileCount == SCAN_PROFILE_MAX) {
+    return -1;
+  }
+  scanProfiles[scanProfileCount] = p;
+  return scanProfileCount++;
+}
+
+static void LoadScanChannels() {
+  scanChCount = 0;
+  scanProfileCount = 0;
+  if (gScanlistSize > SCAN_CH_MAX) {
+    return; // не влезает, прыгаем по-старому
+  }
+  int16_t num = CHANNELS_ScanlistAt(0);
+  for (uint16_t i = 0; i < gScanlistSize; ++i) {
+    CH ch;
+    CHANNELS_Load(num, &ch);
+    int8_t profile = FindScanProfile(&ch);
+    if (profile < 0) {
+      Log("[SCAN] CH working set: too many profiles");
+      return;
+    }
+    scanCh[i] = (ScanCH){.f = ch.rxF, .profile = profile};
+    num = CHANNELS_ScanlistNext(num, true);
+  }
+  scanChCount = gScanlistSize;
+  Log("[SCAN] CH working set: %u, profiles: %u", scanChCount,
+      scanProfileCount);
+}
+
+static void LoadFullScanCH() {
+  CHANNELS_LoadCurrentScanlistCH();
+  vfo->msm.f = ctx->frequency;
+  if (scanChCount) {
+    scanProfileApplied = scanCh[scanChIndex].profile;
+  }
+  scanChFull = true;
+}
+
+// Применяем только отличия от профиля предыдущего канала. Смена чипа
+// перенастраивает всё, а тип кода не задаётся через RADIO_SetParam, поэтому
+// тогда загружаем запись целиком обычным путём
+static void ApplyScanCH(const ScanCH *ch) {
+  const ScanProfile *p = &scanProfiles[ch->profile];
+  const ScanProfile *o = &scanProfiles[scanProfileApplied];
+  if (p->radio != o->radio || p->codeType != o->codeType) {
+    LoadFullScanCH();
+    return;
+  }
+  if (ch->profile != scanProfileApplied) {
+    if (p->modulation != o->modulation) {
+      RADIO_SetParam(ctx, PARAM_MODULATION, p->modulation, false);
+    }
+    if (p->bw != o->bw) {
+      RADIO_SetParam(ctx, PARAM_BANDWIDTH, p->bw, false);
+    }
+    if (p->gain != o->gain) {
+      RADIO_SetParam(ctx, PARAM_GAIN, p->gain, false);
+    }
+    if (p->sqType != o->sqType) {
+      RADIO_SetParam(ctx, PARAM_SQUELCH_TYPE, p->sqType, false);
+    }
+    if (p->sqValue != o->sqValue) {
+      RADIO_SetParam(ctx, PARAM_SQUELCH_VALUE, p->sqValue, false);
+    }
+    if (p->codeValue != o->codeValue) {
+      RADIO_SetParam(ctx, PARAM_RX_CODE, p->codeValue, false);
+    }
+  }
+  // частоту ставит MeasureSignal
+  vfo->msm.f = ch->f;
+  scanProfileApplied = ch->profile;
+  scanChFull = false;
+}
+
+static void NextChannel() {
+  if (vfo->is_open) {
+    vfo->is_open = false;
+    RADIO_SwitchAudioToVFO(gRadioState, gRadioState->active_vfo_index);
+  }
+
+  if (scanChCount && scanChCount == gScanlistSize) {
+    scanChIndex = IncDecU(scanChIndex, 0, scanChCount, true);
+    CHANNELS_SetCurrentScanlistCH(
+        CHANNELS_ScanlistNext(CHANNELS_GetCurrentScanlistCH(), true));
+    ApplyScanCH(&scanCh[scanChIndex]);
+  } else {
+    CHANNELS_Next(true);
+    vfo->msm.f = ctx->frequency;
+  }
+  LOOT_Replace(&vfo->msm, vfo->msm.f);
+}
+
 static void NextStep() {
   switch (scan.mode) {
   case SCAN_MODE_SINGLE:
@@ -123,9 +288,7 @@ static void NextStep() {
 
   case SCAN_MODE_CHANNEL:
     // Переход к следующему каналу
-    CHANNELS_Next(true);
-    CHANNELS_LoadCurrentScanlistCH();
-    LOOT_Replace(&vfo->msm, vfo->msm.f);
+    NextChannel();
     break;
 
   case SCAN_MODE_FREQUENCY:
@@ -146,6 +309,9 @@ static void NextWithTimeout() {
     scan.lastListenState = vfo->is_open;
 
     if (vfo->is_open) {
+      if (scan.mode == SCAN_MODE_CHANNEL && !scanChFull) {
+        LoadFullScanCH();
+      }
       SetTimeout(&scan.scanListenTimeout,
                  SCAN_TIMEOUTS[gSettings.sqOpenedTimeout]);
       SetTimeout(&scan.stayAtTimeout, UINT32_MAX);
@@ -156,7 +322,14 @@ static void NextWithTimeout() {
 
   if ((CheckTimeout(&scan.scanListenTimeout) && vfo->is_open) ||
       CheckTimeout(&scan.stayAtTimeout)) {
-    NextFrequency();
+    if (scan.mode == SCAN_MODE_CHANNEL) {
+      NextChannel();
+      SetTimeout(&scan.scanListenTimeout, 0);
+      SetTimeout(&scan.stayAtTimeout, 0);
+      UpdateCPS();
+    } else {
+      NextFrequency();
+    }
   }
 }
 
@@ -172,7 +345,7 @@ const char *SCAN_MODE_NAMES[] = {
 // API для установки режима
 void SCAN_SetMode(ScanMode mode) {
   scan.mode = mode;
-  Log("[SCAN] mode=%s", SCAN_MODE_NAMES[scan.mode]);
+  TRACE(TR_SCAN_MODE, scan.mode, 0, 0);
 
   // Сброс состояния при смене режима
   scan.scanCycles = 0;
@@ -188,7 +361,18 @@ void SCAN_SetMode(ScanMode mode) {
     break;
   case SCAN_MODE_CHANNEL:
     // Загрузим первый канал из списка
-    CHANNELS_LoadCurrentScanlistCH();
+    LoadScanChannels();
+    if (scanChCount) {
+      // индекс в наборе и текущий слот должны идти в ногу
+      int16_t cur = CHANNELS_GetCurrentScanlistCH();
+      int16_t index = cur < 0 ? -1 : CHANNELS_ScanlistIndexOf(cur);
+      if (index < 0) {
+        index = 0;
+        CHANNELS_SetCurrentScanlistCH(CHANNELS_ScanlistAt(0));
+      }
+      scanChIndex = index;
+    }
+    LoadFullScanCH();
     break;
   case SCAN_MODE_FREQUENCY:
   case SCAN_MODE_ANALYSER:
@@ -254,7 +438,7 @@ void SCAN_Init(bool multiband) {
 static void HandleAnalyserMode() {
   vfo->msm.rssi = MeasureSignal(vfo->msm.f, false);
   scan.scanCycles++;
-  SP_AddPoint(&vfo->msm);
+  AddPoint();
   NextFrequency();
 }
 
@@ -265,7 +449,7 @@ static void UpdateSquelchAndRssi(bool isAnalyserMode) {
       (msm && (msm->blacklist || msm->whitelist))) {
     vfo->msm.open = false;
     vfo->msm.rssi = 0;
-    SP_AddPoint(&vfo->msm);
+    AddPoint();
     NextFrequency();
     return;
   }
@@ -285,7 +469,7 @@ static void UpdateSquelchAndRssi(bool isAnalyserMode) {
   }
 
   vfo->msm.open = vfo->msm.rssi >= scan.squelchLevel;
-  SP_AddPoint(&vfo->msm);
+  AddPoint();
 }
 
 void SCAN_Check() {
@@ -294,7 +478,7 @@ void SCAN_Check() {
   // Режим анализатора — упрощенная логика
   if (scan.mode == SCAN_MODE_ANALYSER) {
     vfo->msm.rssi = MeasureSignal(vfo->msm.f, false);
-    SP_AddPoint(&vfo->msm);
+    AddPoint();
     NextStep();
     return;
   }
@@ -310,9 +494,8 @@ void SCAN_Check() {
     RADIO_CheckAndSaveVFO(gRadioState);
     if (Now() - radioTimer >= SQL_DELAY) {
       RADIO_UpdateSquelch(gRadioState);
-      Log("SQL? %u RNG %u %u %u", vfo->msm.open, vfo->msm.rssi, vfo->msm.noise,
-          vfo->msm.glitch);
-      SP_ShiftGraph(-1);
+      TRACE(TR_SQL, vfo->msm.noise, vfo->msm.rssi,
+            vfo->msm.glitch | (vfo->msm.open << 8));
       SP_AddGraphPoint(&vfo->msm);
       radioTimer = Now();
     }
@@ -324,7 +507,7 @@ void SCAN_Check() {
   if (vfo->msm.open) {
     RADIO_UpdateSquelch(gRadioState);
     vfo->msm.open = vfo->is_open;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_SPECTRUM | WIDGET_FREQ);
   } else {
     UpdateSquelchAndRssi(scan.mode == SCAN_MODE_ANALYSER);
   }
@@ -379,7 +562,7 @@ void SCAN_Check() {
   if (vfo->msm.open) {
     RADIO_UpdateSquelch(gRadioState);
     vfo->msm.open = vfo->is_open;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_SPECTRUM);
   } else {
     UpdateSquelchAndRssi(isAnalyserMode);
   }
@@ -404,7 +587,7 @@ void SCAN_Check() {
   }
 
   if (vfo->msm.open) {
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_SPECTRUM); // полоса RSSI
   }
 
   static uint8_t stepsPassed;
@@ -424,5 +607,10 @@ void SCAN_Check() {
   NextWithTimeout();
 } */
 
+// Тот же путь измерения, что и у сканера, для удалённой развёртки
+uint16_t SCAN_Measure(uint32_t f, uint32_t dwellUs) {
+  return MeasureSignalDwell(f, true, dwellUs);
+}
+
 void SCAN_SetDelay(uint32_t delay) { scan.scanDelayUs = delay; }
 uint32_t SCAN_GetDelay() { return scan.scanDelayUs; }
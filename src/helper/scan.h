@@ -31,6 +31,8 @@ uint32_t SCAN_GetCps();
 void SCAN_NextBlacklist();
 void SCAN_NextWhitelist();
 
+uint16_t SCAN_Measure(uint32_t f, uint32_t dwellUs);
+
 void SCAN_SetDelay(uint32_t delay);
 uint32_t SCAN_GetDelay();
 
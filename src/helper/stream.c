@@ -0,0 +1,88 @@
+#include "stream.h"
+#include "../driver/bk4819.h"
+#include "../driver/uart.h"
+#include <string.h>
+
+// Бинарный поток спектра: кадр 0x0540 на каждые STREAM_SEG шагов развёртки.
+// Значения квантуются в байт, кадр на 32 шага - 24..120 байт по проводу.
+#define STREAM_SEG 32
+
+typedef struct {
+  uint16_t ID;
+  uint16_t Size;
+  uint16_t Seq;   // номер кадра, пропуски = потери
+  uint8_t Flags;  // STREAM_F_*
+  uint8_t Count;  // шагов в кадре
+  uint32_t StartF;
+  uint32_t Step;
+  uint8_t Data[STREAM_SEG * 3]; // rssi[Count], noise[Count], glitch[Count]
+} StreamFrame;
+
+#define STREAM_F_FULL 1
+
+static StreamFrame frame;
+static StreamMode mode;
+static uint16_t seq;
+
+void STREAM_SetMode(StreamMode m) {
+  mode = m;
+  frame.Count = 0;
+}
+
+StreamMode STREAM_GetMode(void) { return mode; }
+
+void STREAM_Flush(void) {
+  if (!frame.Count) {
+    return;
+  }
+
+  uint8_t n = frame.Count;
+  bool full = mode == STREAM_FULL;
+
+  if (full) {
+    // noise и glitch копились с шагом STREAM_SEG, сжимаем к Count
+    memmove(frame.Data + n, frame.Data + STREAM_SEG, n);
+    memmove(frame.Data + n * 2, frame.Data + STREAM_SEG * 2, n);
+  }
+
+  frame.ID = 0x0540;
+  frame.Size = 12 + n * (full ? 3 : 1);
+  frame.Seq = seq++;
+  frame.Flags = full ? STREAM_F_FULL : 0;
+
+  // Нет места в TX - кадр теряется, скан не ждёт провода
+  UART_SendFrame(&frame, 4 + frame.Size);
+  frame.Count = 0;
+}
+
+void STREAM_AddPoint(const Measurement *msm, uint32_t step) {
+  if (mode == STREAM_OFF) {
+    return;
+  }
+
+  // Разрыв развёртки (новый проход, смена шага) - начинаем новый кадр
+  if (frame.Count &&
+      (frame.Step != step || msm->f != frame.StartF + frame.Count * step)) {
+    STREAM_Flush();
+  }
+
+  if (!frame.Count) {
+    frame.StartF = msm->f;
+    frame.Step = step;
+  }
+
+  uint8_t i = frame.Count++;
+  // RSSI в шагах 0.5 дБ, 9 бит -> байт с шагом 1 дБ: dBm = q - 160
+  frame.Data[i] = msm->rssi >> 1;
+  // Развёртка читает только RSSI, поэтому FULL добавляет на шаг два чтения
+  // регистров BK4819 (строка "Noise+glt" в бенчмарке). RSSI-режим их не
+  // делает - для съёмки на скорости скана нужен он
+  if (mode == STREAM_FULL) {
+    frame.Data[STREAM_SEG + i] = BK4819_GetNoise();
+    frame.Data[STREAM_SEG * 2 + i] = BK4819_GetGlitch();
+  }
+
+  if (frame.Count == STREAM_SEG) {
+    STREAM_Flush();
+  }
+}
@@ -0,0 +1,18 @@
+#ifndef STREAM_HELPER_H
+#define STREAM_HELPER_H
+
+#include "lootlist.h"
+#include <stdint.h>
+
+typedef enum {
+  STREAM_OFF,
+  STREAM_RSSI, // только RSSI
+  STREAM_FULL, // RSSI + noise + glitch
+} StreamMode;
+
+void STREAM_SetMode(StreamMode mode);
+StreamMode STREAM_GetMode(void);
+void STREAM_AddPoint(const Measurement *msm, uint32_t step);
+void STREAM_Flush(void);
+
+#endif /* end of include guard: STREAM_HELPER_H */
@@ -0,0 +1,71 @@
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include "../driver/systick.h"
+#include "../driver/uart.h"
+
+#define TRACE_SIZE 64 // степень двойки
+#define TRACE_FRAME_MAX 8
+
+typedef struct {
+  uint32_t t;
+  uint16_t id;
+  uint16_t a;
+  uint32_t b;
+  uint32_t c;
+} TraceEntry;
+
+static TraceEntry ring[TRACE_SIZE];
+static uint16_t head;
+static uint16_t tail;
+static uint16_t dropped;
+
+void TRACE_Put(TraceEvent id, uint16_t a, uint32_t b, uint32_t c) {
+  TraceEntry *e = &ring[head & (TRACE_SIZE - 1)];
+
+  e->t = GetUptimeUs();
+  e->id = id;
+  e->a = a;
+  e->b = b;
+  e->c = c;
+  head++;
+
+  // Переполнение: затираем самое старое
+  if ((uint16_t)(head - tail) > TRACE_SIZE) {
+    tail++;
+    dropped++;
+  }
+}
+
+// Выгрузка кадром 0x0550, только когда TX простаивает
+void TRACE_Drain(void) {
+  struct {
+    uint16_t ID;
+    uint16_t Size;
+    uint16_t Dropped; // потеряно с прошлого кадра
+    uint8_t Count;
+    uint8_t Padding;
+    TraceEntry Entries[TRACE_FRAME_MAX];
+  } frame;
+
+  if (head == tail || !UART_IsTxIdle()) {
+    return;
+  }
+
+  uint8_t n = 0;
+  while (tail != head && n < TRACE_FRAME_MAX) {
+    frame.Entries[n++] = ring[tail & (TRACE_SIZE - 1)];
+    tail++;
+  }
+
+  frame.ID = 0x0550;
+  frame.Size = 4 + n * sizeof(TraceEntry);
+  frame.Dropped = dropped;
+  frame.Count = n;
+  dropped = 0;
+
+  UART_SendFrame(&frame, 4 + frame.Size);
+}
+
+#endif
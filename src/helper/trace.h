@@ -0,0 +1,38 @@
+#ifndef TRACE_HELPER_H
+#define TRACE_HELPER_H
+
+#include <stdint.h>
+
+// Бинарная трассировка: событие = время (мкс), id и до трёх аргументов.
+// Форматирование на стороне ПК (tracelog.py строит таблицу из этого списка),
+// формат: {a} 16 бит, {b} и {c} 32 бита, допустимы выражения вида {c>>8}.
+#define TRACE_EVENTS(X)                                                        \
+  X(TR_SCAN_MODE, "scan mode={a}")                                             \
+  X(TR_SCAN_BAND, "scan bounds {b} .. {c}")                                    \
+  X(TR_SQL, "sql open={c>>8} rssi={b} noise={a} glitch={c&0xFF}")              \
+  X(TR_PARAM_SET, "param set #{a} -> {b}{' [W]' if c else ''}")                \
+  X(TR_PARAM_APPLY, "param apply #{a} -> {b}")                                 \
+  X(TR_PARAM_SKIP, "param #{a} not set for radio {b}")                         \
+  X(TR_RENDER, "render {a:x} {b} us")                                         \
+  X(TR_UART_CMD, "uart cmd 0x{a:04X}")                                         \
+  X(TR_EEPROM_WRITE, "eeprom write {b:#x} +{a}")
+
+#define TRACE_ID(name, fmt) name,
+typedef enum { TRACE_EVENTS(TRACE_ID) TR_COUNT } TraceEvent;
+#undef TRACE_ID
+
+// В релизе трассировка не занимает ни RAM, ни тактов
+#ifdef DEBUG
+#define TRACE_ENABLED 1
+#endif
+
+#ifdef TRACE_ENABLED
+void TRACE_Put(TraceEvent id, uint16_t a, uint32_t b, uint32_t c);
+void TRACE_Drain(void);
+#define TRACE(id, a, b, c) TRACE_Put(id, a, b, c)
+#else
+#define TRACE(id, a, b, c) ((void)0)
+#define TRACE_Drain() ((void)0)
+#endif
+
+#endif /* end of include guard: TRACE_HELPER_H */
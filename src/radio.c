@@ -16,9 +16,11 @@
 #include "helper/channels.h"
 #include "helper/lootlist.h"
 #include "helper/measurements.h"
+#include "helper/trace.h"
 #include "misc.h"
 #include "scheduler.h"
 #include "settings.h"
+#include "ui/widgets.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -1025,8 +1027,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
   }
 
 #ifdef DEBUG_PARAMS
-  LogC(LOG_C_WHITE, "[SET] %-12s -> %s%s", PARAM_NAMES[param],
-       RADIO_GetParamValueString(ctx, param), save_to_eeprom ? " [W]" : "");
+  TRACE(TR_PARAM_SET, param, value, save_to_eeprom);
 #endif /* ifdef DEBUG_PARAMS */
 
   // TODO: make dirty only when changed.
@@ -1286,15 +1287,13 @@ void RADIO_ApplySettings(VFOContext *ctx) {
 
     if (!setParamForRadio[ctx->radio_type](ctx, p)) {
 #ifdef DEBUG_PARAMS
-      LogC(LOG_C_YELLOW, "[W] Param %s not set for %s", PARAM_NAMES[p],
-           RADIO_NAMES[ctx->radio_type]);
+      TRACE(TR_PARAM_SKIP, p, ctx->radio_type, 0);
 #endif
       continue;
     }
     ctx->dirty[p] = false;
 #ifdef DEBUG_PARAMS
-    LogC(LOG_C_BRIGHT_WHITE, "[SET] %-12s -> %s", PARAM_NAMES[p],
-         RADIO_GetParamValueString(ctx, p));
+    TRACE(TR_PARAM_APPLY, p, RADIO_GetParam(ctx, p), 0);
 #endif /* ifdef DEBUG_PARAMS */
   }
 
@@ -1446,7 +1445,7 @@ static bool RADIO_SwitchVFOTemp(RadioState *state, uint8_t vfo_index) {
   // Activate new VFO
   state->vfos[vfo_index].is_active = true;
   state->active_vfo_index = vfo_index;
-  gRedrawScreen = true;
+  UI_Invalidate(WIDGET_SPECTRUM | WIDGET_FREQ); // частота и настройки VFO
   // updateContext();
 
   // Apply settings for the new VFO
@@ -1721,7 +1720,7 @@ void RADIO_UpdateSquelch(RadioState *state) {
   } */
   RADIO_UpdateMeasurement(&state->vfos[state->active_vfo_index]);
   if (vfo->msm.open != vfo->is_open) {
-    gRedrawScreen = true; // TODO: mv
+    UI_Invalidate(WIDGET_SPECTRUM); // полоса RSSI
     // RADIO_SetParam(ctx, PARAM_AFC_SPD, vfo->msm.open ? 57 : 63, false);
     RADIO_ApplySettings(ctx);
     vfo->is_open = vfo->msm.open;
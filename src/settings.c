@@ -184,6 +184,8 @@ uint32_t SETTINGS_GetValue(Setting s) {
     return gSettings.contrast;
   case SETTING_MAINAPP:
     return gSettings.mainApp;
+  case SETTING_DEBUGAPPS:
+    return gSettings.debugApps;
   case SETTING_SQOPENEDTIMEOUT:
     return gSettings.sqOpenedTimeout;
   case SETTING_SQCLOSEDTIMEOUT:
@@ -303,6 +305,9 @@ void SETTINGS_SetValue(Setting s, uint32_t v) {
   case SETTING_MAINAPP:
     gSettings.mainApp = v;
     break;
+  case SETTING_DEBUGAPPS:
+    gSettings.debugApps = v;
+    break;
   case SETTING_SQOPENEDTIMEOUT:
     gSettings.sqOpenedTimeout = v;
     break;
@@ -381,6 +386,7 @@ const char *SETTINGS_GetValueString(Setting s) {
   case SETTING_SKIPGARBAGEFREQUENCIES:
   case SETTING_DTMFDECODE:
   case SETTING_PTT_LOCK:
+  case SETTING_DEBUGAPPS:
     return YES_NO[v];
 
   case SETTING_BEEP:
@@ -481,6 +487,7 @@ void SETTINGS_IncDecValue(Setting s, bool inc) {
   case SETTING_KEYLOCK:
   case SETTING_PTT_LOCK:
   case SETTING_STE:
+  case SETTING_DEBUGAPPS:
     ma = 2;
     break;
   case SETTING_MULTIWATCH:
@@ -501,7 +508,8 @@ void SETTINGS_IncDecValue(Setting s, bool inc) {
     break;
   case SETTING_MAINAPP: {
     int8_t found_index = -1;
-    for (uint8_t i = 0; i < RUN_APPS_COUNT; i++) {
+    uint8_t count = APPS_GetRunCount();
+    for (uint8_t i = 0; i < count; i++) {
       if (appsAvailableToRun[i] == v) {
         found_index = i;
         break;
@@ -512,7 +520,7 @@ void SETTINGS_IncDecValue(Setting s, bool inc) {
       v = appsAvailableToRun[0];
     }
 
-    uint8_t next_index = IncDecU(found_index, 0, RUN_APPS_COUNT, inc);
+    uint8_t next_index = IncDecU(found_index, 0, count, inc);
     v = appsAvailableToRun[next_index];
     SETTINGS_SetValue(s, v);
     return;
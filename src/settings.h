@@ -50,6 +50,7 @@ typedef enum {
   SETTING_FCTIME,
   SETTING_MULTIWATCH,
   SETTING_FREQ_CORRECTION,
+  SETTING_DEBUGAPPS,
 
   SETTING_COUNT,
 } Setting;
@@ -131,14 +132,16 @@ typedef struct {
   uint8_t backlight : 4;
   uint8_t mic : 4;
 
-  uint8_t reserved3 : 4;
+  bool debugApps : 1;      // показывать отладочные приложения
+  uint8_t chSortCheck : 2; // chSortOrder ^ 3, отсекает мусор в старых образах
+  uint8_t reserved3 : 1;
   uint8_t batsave : 4;
 
   uint8_t vox : 4;
   uint8_t txTime : 4;
 
   uint8_t fcTime : 2;
-  uint8_t reserved5 : 2;
+  uint8_t chSortOrder : 2; // незавершённая сортировка каналов
   uint8_t iAmPro : 1;
   uint8_t roger : 3;
 
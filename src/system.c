@@ -4,18 +4,22 @@
 #include "driver/eeprom.h"
 #include "driver/keyboard.h"
 #include "driver/st7565.h"
+#include "driver/systick.h"
 #include "driver/uart.h"
 #include "external/CMSIS_5/Device/ARM/ARMCM0/Include/ARMCM0.h"
 #include "helper/bands.h"
 #include "helper/battery.h"
 #include "helper/menu.h"
+#include "helper/profile.h"
 #include "helper/scan.h"
+#include "helper/trace.h"
 #include "radio.h"
 #include "scheduler.h"
 #include "settings.h"
 #include "ui/graphics.h"
 #include "ui/spectrum.h"
 #include "ui/statusline.h"
+#include "ui/widgets.h"
 #include <string.h>
 
 #define queueLen 20
@@ -37,7 +41,7 @@ static bool isUartWaiting() {
 }
 
 static void appRender() {
-  if (!gRedrawScreen) {
+  if (!gRedrawScreen && !gDirtyWidgets) {
     return;
   }
 
@@ -45,21 +49,40 @@ static void appRender() {
     return;
   }
 
+  // DMA ещё читает кадр - не стираем его под ним
+  if (ST7565_IsBusy()) {
+    return;
+  }
+
+  uint8_t dirty = gRedrawScreen ? 0xFF : gDirtyWidgets;
   gRedrawScreen = false;
+  gDirtyWidgets = 0;
+
+  uint32_t renderStart = GetUptimeUs();
+
+  // Уведомление лежит поверх всего - с ним только полная перерисовка
+  if (dirty == 0xFF || notificationMessage[0] || !APPS_renderDirty(dirty)) {
+    dirty = 0xFF;
 
-  UI_ClearScreen();
+    UI_ClearScreen();
 
-  APPS_render();
+    APPS_render();
 
-  if (notificationMessage[0]) {
-    FillRect(0, 32 - 5, 128, 9, C_FILL);
-    PrintMediumEx(64, 32 + 2, POS_C, C_CLEAR, notificationMessage);
+    if (notificationMessage[0]) {
+      FillRect(0, 32 - 5, 128, 9, C_FILL);
+      PrintMediumEx(64, 32 + 2, POS_C, C_CLEAR, notificationMessage);
+    }
   }
 
-  STATUSLINE_render(); // coz of APPS_render calls STATUSLINE_SetText
+  if (dirty & WIDGET_STATUS) {
+    STATUSLINE_render(); // coz of APPS_render calls STATUSLINE_SetText
+  }
 
-  ST7565_Blit();
+  ST7565_BlitAsync();
   gLastRender = Now();
+  uint32_t renderUs = GetUptimeUs() - renderStart;
+  PROF_Add(PROF_RENDER, renderUs);
+  TRACE(TR_RENDER, dirty, renderUs, 0);
 }
 
 static void systemUpdate() {
@@ -115,9 +138,20 @@ static void processKeyboard() {
       return;
     }
 
-    if (APPS_key(n.key, n.state) || (MENU_IsActive() && n.key != KEY_EXIT)) {
+    // Перемещение по меню и смена значения отмечают только строки меню,
+    // остальные обработчики по-прежнему ведут к полной перерисовке
+    const uint8_t dirtyBefore = gDirtyWidgets;
+    gDirtyWidgets = 0;
+    const bool handled =
+        APPS_key(n.key, n.state) || (MENU_IsActive() && n.key != KEY_EXIT);
+    const uint8_t keyDirty = gDirtyWidgets;
+    gDirtyWidgets |= dirtyBefore;
+
+    if (handled) {
       // LogC(LOG_C_BRIGHT_WHITE, "[SYS] Apps key");
-      gRedrawScreen = true;
+      if (!(keyDirty & WIDGET_MENU)) {
+        gRedrawScreen = true;
+      }
       gLastRender = 0;
     } else {
       // LogC(LOG_C_BRIGHT_WHITE, "[SYS] Global key");
@@ -163,6 +197,14 @@ void SYS_Main() {
     STATUSLINE_render();
     ST7565_Blit();
 
+    if (CHANNELS_PendingSort() != CH_SORT_NONE) {
+      LogC(LOG_C_BRIGHT_WHITE, "RESUME CH SORT");
+      CHANNELS_Sort(gSettings.chSortOrder);
+    }
+
+    LogC(LOG_C_BRIGHT_WHITE, "LOAD CH INDEX");
+    CHANNELS_LoadIndex();
+
     LogC(LOG_C_BRIGHT_WHITE, "LOAD BANDS");
     BANDS_Load();
 
@@ -171,38 +213,63 @@ void SYS_Main() {
   }
 
   for (;;) {
+    uint32_t loopStart = GetUptimeUs();
+    uint32_t t = loopStart;
 
     SETTINGS_UpdateSave();
+    t = PROF_Mark(PROF_SETTINGS, t);
 
     if (gCurrentApp != APP_RESET) {
       SCAN_Check();
+      t = PROF_Mark(PROF_SCAN, t);
     }
 
     APPS_update();
+    t = PROF_Mark(PROF_APPS, t);
 
     // common: render 2 times per second minimum
     if (Now() - gLastRender >= 500) {
-      gRedrawScreen = true;
+      UI_Invalidate(WIDGET_STATUS | WIDGET_SPECTRUM | WIDGET_FREQ |
+                    WIDGET_LOOT);
     }
 
     if (Now() - appsKeyboardTimer >= 14) {
+      t = GetUptimeUs();
       processKeyboard();
       appsKeyboardTimer = Now();
+      PROF_Mark(PROF_KEYS, t);
     }
 
     if (Now() - secondTimer >= 1000) {
+      t = GetUptimeUs();
       STATUSLINE_update();
       systemUpdate();
       secondTimer = Now();
+      PROF_Mark(PROF_SYSTEM, t);
     }
 
     appRender();
 
-    while (gCurrentApp != APP_SCANER && UART_IsCommandAvailable()) {
+    ST7565_Update();
+    UART_Update();
+    TRACE_Drain();
+    while (UART_IsCommandAvailable()) {
+      // Сканер принимает только короткие команды: поток, регистры, профиль
+      bool clone = UART_IsCloneCommand();
+      if (gCurrentApp == APP_SCANER && (clone || UART_IsLongCommand())) {
+        continue;
+      }
+      t = GetUptimeUs();
       UART_HandleCommand();
+      if (clone) {
+        CHANNELS_InvalidateCaches();
+      }
       lastUartDataTime = Now();
+      PROF_Mark(PROF_UART, t);
     }
 
+    PROF_Mark(PROF_LOOP, loopStart);
+
     // __WFI();
   }
 }
@@ -20,4 +20,11 @@ typedef struct {       // Data stored for FONT AS A WHOLE:
   uint8_t yAdvance;    // Newline distance (y axis)
 } GFXfont;
 
+// Глифы в столбцах по 8 строк, как в буфере экрана (font-atlas.py)
+typedef struct {
+  const GFXfont *font;
+  const uint8_t *data;     // [страница глифа][столбец]
+  const uint16_t *offset;  // начало глифа в data
+} GlyphAtlas;
+
 #endif // _GFXFONT_H_
@@ -9,8 +9,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef ENABLE_GLYPH_ATLAS
+#include "fontatlas.h" // генерирует font-atlas.py при GLYPH_ATLAS=1
+#endif
+
 static Cursor cursor;
 
+bool gPixelFill = false;
+
 static const GFXfont *const fonts[] = {&TomThumb, &MuMatrix8ptRegular,
                                        &muHeavy8ptBold, &dig_11, &dig_14};
 
@@ -23,7 +29,11 @@ void PutPixel(uint8_t x, uint8_t y, uint8_t fill) {
   if (x >= LCD_WIDTH || y >= LCD_HEIGHT)
     return;
   uint8_t m = 1 << (y & 7), *p = &gFrameBuffer[y >> 3][x];
-  *p = fill ? (fill & 2 ? *p ^ m : *p | m) : *p & ~m;
+  uint8_t v = fill ? (fill & 2 ? *p ^ m : *p | m) : *p & ~m;
+  if (v != *p) {
+    *p = v;
+    ST7565_MarkDirty(y >> 3, x, x);
+  }
 }
 
 bool GetPixel(uint8_t x, uint8_t y) {
@@ -52,13 +62,35 @@ static void DrawALine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
   }
 }
 
+// Одна страница: маска m на столбцах [x, x + w)
+static void FillSpan(uint8_t page, uint8_t x, uint8_t w, uint8_t m, Color c) {
+  uint8_t *p = &gFrameBuffer[page][x];
+  uint8_t lo = 0xFF, hi = 0;
+
+  for (uint8_t i = 0; i < w; ++i) {
+    uint8_t v = c ? (c & 2 ? p[i] ^ m : p[i] | m) : p[i] & ~m;
+    if (v != p[i]) {
+      p[i] = v;
+      if (lo == 0xFF)
+        lo = i;
+      hi = i;
+    }
+  }
+  if (lo != 0xFF)
+    ST7565_MarkDirty(page, x + lo, x + hi);
+}
+
 void DrawVLine(int16_t x, int16_t y, int16_t h, Color c) {
-  if (h)
+  if (h > 0)
+    FillRect(x, y, 1, h, c);
+  else if (h)
     DrawALine(x, y, x, y + h - 1, c);
 }
 
 void DrawHLine(int16_t x, int16_t y, int16_t w, Color c) {
-  if (w)
+  if (w > 0)
+    FillRect(x, y, w, 1, c);
+  else if (w)
     DrawALine(x, y, x + w - 1, y, c);
 }
 
@@ -82,13 +114,84 @@ void DrawRect(int16_t x, int16_t y, int16_t w, int16_t h, Color c) {
   DrawVLine(x + w - 1, y, h, c);
 }
 
+// По страницам: на каждую не больше w байтовых операций с маской
 void FillRect(int16_t x, int16_t y, int16_t w, int16_t h, Color c) {
-  for (int16_t i = x, e = x + w; i < e; i++)
-    DrawVLine(i, y, h, c);
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > LCD_WIDTH)
+    w = LCD_WIDTH - x;
+  if (y + h > LCD_HEIGHT)
+    h = LCD_HEIGHT - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  if (gPixelFill) {
+    for (int16_t xx = x; xx < x + w; ++xx)
+      for (int16_t yy = y; yy < y + h; ++yy)
+        PutPixel(xx, yy, c);
+    return;
+  }
+
+  uint8_t y1 = y + h - 1, p0 = y >> 3, p1 = y1 >> 3;
+  for (uint8_t page = p0; page <= p1; ++page) {
+    uint8_t m = 0xFF;
+    if (page == p0)
+      m &= 0xFF << (y & 7);
+    if (page == p1)
+      m &= 0xFF >> (7 - (y1 & 7));
+    FillSpan(page, x, w, m, c);
+  }
 }
 
+#ifdef ENABLE_GLYPH_ATLAS
+// Столбцы глифа сдвигаются в одну или две страницы; на границе страницы
+// (y кратен 8) это просто байт на столбец
+static bool putAtlasChar(int16_t x, int16_t y, uint8_t c, Color col,
+                         const GFXfont *f) {
+  const GlyphAtlas *a = NULL;
+  for (uint8_t i = 0; i < ARRAY_SIZE(glyphAtlases); ++i) {
+    if (glyphAtlases[i].font == f) {
+      a = &glyphAtlases[i];
+      break;
+    }
+  }
+
+  const GFXglyph *g = &f->glyph[c - f->first];
+  int16_t top = y + g->yOffset;
+  if (!a || top < 0 || top + g->height > LCD_HEIGHT)
+    return false;
+
+  const uint8_t *d = a->data + a->offset[c - f->first];
+  uint8_t w = g->width, shift = top & 7;
+  int16_t left = x + g->xOffset;
+
+  for (uint8_t j = 0; j * 8 < g->height; ++j, d += w) {
+    uint8_t page = (top >> 3) + j;
+    for (uint8_t xx = 0; xx < w; ++xx) {
+      int16_t px = left + xx;
+      if (px < 0 || px >= LCD_WIDTH || !d[xx])
+        continue;
+      FillSpan(page, px, 1, d[xx] << shift, col);
+      if (shift && (d[xx] >> (8 - shift)))
+        FillSpan(page + 1, px, 1, d[xx] >> (8 - shift), col);
+    }
+  }
+  return true;
+}
+#endif
+
 static void m_putchar(int16_t x, int16_t y, uint8_t c, Color col, uint8_t sx,
                       uint8_t sy, const GFXfont *f) {
+#ifdef ENABLE_GLYPH_ATLAS
+  if (sx == 1 && sy == 1 && putAtlasChar(x, y, c, col, f))
+    return;
+#endif
   const GFXglyph *g = &f->glyph[c - f->first];
   const uint8_t *b = f->bitmap + g->bitmapOffset;
   uint8_t w = g->width, h = g->height, bits = 0, bit = 0;
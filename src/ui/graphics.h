@@ -47,6 +47,9 @@ typedef struct {
   uint8_t y;
 } Cursor;
 
+// Заливка по пикселю, как до страничного пути. Только для бенчмарка
+extern bool gPixelFill;
+
 void UI_ClearStatus();
 void UI_ClearScreen();
 
@@ -1,25 +1,132 @@
 #include "spectrum.h"
 #include "../driver/uart.h"
 #include "../helper/measurements.h"
+#include "../scheduler.h"
 #include "components.h"
 #include "graphics.h"
+#include "waterfall.h"
+#include "widgets.h"
 #include <stdint.h>
+#include <string.h>
 
 #define MAX_POINTS 128
 
 uint8_t SPECTRUM_Y = 8;
 uint8_t SPECTRUM_H = 44;
 GraphMeasurement graphMeasurement = GRAPH_RSSI;
+GraphTimeBase graphTimeBase = GRAPH_BASE_FAST;
 
 static uint8_t S_BOTTOM;
 
 static uint16_t rssiHistory[MAX_POINTS] = {0};
-static uint16_t rssiGraphHistory[MAX_POINTS] = {0};
+// График во времени: кольцо на каждую шкалу времени, в каждом элементе все
+// серии сразу, поэтому смена серии не теряет историю. Значения в 8 бит -
+// диапазоны отображения серий в них укладываются. Длинные шкалы копят
+// среднее за период и пишут точку раз в период; их кольца короче и
+// рисуются растянутыми
+#define GRAPH_FAST_LEN MAX_POINTS
+#define GRAPH_SLOW_LEN (MAX_POINTS / 4)
+
+typedef uint8_t GraphSample[GRAPH_COUNT];
+
+typedef struct {
+  GraphSample *data;
+  uint32_t periodMs; // 0 - точка на каждый замер
+  uint32_t next;
+  uint16_t sum[GRAPH_COUNT];
+  uint8_t n;
+  uint8_t len;
+  uint8_t head; // куда пишется следующая точка
+  uint8_t count;
+} GraphRing;
+
+static GraphSample graphFast[GRAPH_FAST_LEN];
+static GraphSample graph1s[GRAPH_SLOW_LEN];
+static GraphSample graph10s[GRAPH_SLOW_LEN];
+
+static GraphRing graphRings[GRAPH_BASE_COUNT] = {
+    [GRAPH_BASE_FAST] = {.data = graphFast, .len = GRAPH_FAST_LEN},
+    [GRAPH_BASE_1S] = {.data = graph1s, .len = GRAPH_SLOW_LEN,
+                       .periodMs = 1000},
+    [GRAPH_BASE_10S] = {.data = graph10s, .len = GRAPH_SLOW_LEN,
+                        .periodMs = 10000},
+};
+
+static const char *GRAPH_BASE_NAMES[GRAPH_BASE_COUNT] = {
+    [GRAPH_BASE_FAST] = "",
+    [GRAPH_BASE_1S] = "1s",
+    [GRAPH_BASE_10S] = "10s",
+};
 
 static uint8_t x = 0;
 static uint8_t ox = UINT8_MAX;
 static uint8_t filledPoints;
 
+// Сводка по rssiHistory, ведётся при записи столбца, а не проходом по
+// массиву на каждый кадр. Столбцы за filledPoints всегда нулевые
+static uint32_t sumSq;    // для шумового порога (RMS)
+static uint16_t histMax;  //
+static uint16_t histMin;  // минимальный ненулевой
+static bool extremaStale; // перезаписан столбец с экстремумом
+
+// Столбцы, изменившиеся после последнего SP_Render, и их высоты в пикселях
+static uint32_t changedCols[MAX_POINTS / 32];
+static uint8_t barH[MAX_POINTS];
+static VMinMax barScaleV;
+static uint8_t barScaleH;
+static uint32_t barScaleQ16; // SPECTRUM_H / (vMax - vMin) в Q16
+
+// Накопитель выбранной трассы, 0 - столбец ещё пуст. Обновляется один раз
+// на столбец за проход, когда развёртка уходит на следующий столбец
+#define AVG_SHIFT 4 // дробная часть среднего
+#define AVG_K 3     // вес нового значения 1/8
+static uint16_t traceAcc[MAX_POINTS];
+// Границы значений трассы для шкалы: за проход только расширяются, в конце
+// прохода считаются заново, чтобы шкала сжималась вслед за трассой
+static uint16_t traceMax;
+static uint16_t traceMin = UINT16_MAX; // минимальный ненулевой
+static SpectrumTrace traceMode = SP_TRACE_LIVE;
+static bool traceOverlay;
+
+static const char *TRACE_NAMES[SP_TRACE_COUNT] = {
+    [SP_TRACE_LIVE] = "",
+    [SP_TRACE_MAX_HOLD] = "MAX",
+    [SP_TRACE_AVERAGE] = "AVG",
+    [SP_TRACE_MIN_HOLD] = "MIN",
+};
+
+// Сведение шагов в столбец, когда шагов больше, чем столбцов. Шаг s
+// диапазона из stepsTotal шагов ложится в столбцы
+// [s * MAX_POINTS / stepsTotal, (s + 1) * MAX_POINTS / stepsTotal - 1],
+// так что границы корзин не пересекаются и не зависят от округления частоты.
+// Развёртка идёт по порядку, поэтому граница следующего шага считается
+// накоплением остатка, без деления на каждый замер.
+// В rssiHistory всегда RSSI (шумодав, шумовой порог и водопад берут его);
+// занятость - отдельный массив только для столбцов, со своей шкалой 0..100%
+#define BIN_MARGIN 12  // порог занятости над средним прошлого прохода
+#define BIN_PERCENT 100 // занятость в столбце - проценты шагов над порогом
+static SpectrumBin binMode = SP_BIN_MAX;
+static uint32_t stepsTotal;
+static uint32_t binS;       // шаг, для которого посчитаны границы
+static uint8_t binX;        // первый столбец шага binS
+static uint8_t binNextX;    // первый столбец шага binS + 1
+static uint32_t binRem;     // binS * MAX_POINTS % stepsTotal
+static uint32_t binNextRem; // то же для binS + 1
+static uint32_t binSum;
+static uint32_t binCount;
+static uint32_t binAbove;
+static uint16_t binMax;
+static uint16_t binThreshold = UINT16_MAX; // до первого прохода не занято
+static uint32_t sweepSum;
+static uint32_t sweepCount;
+static uint8_t occupancy[MAX_POINTS];
+
+static const char *BIN_NAMES[SP_BIN_COUNT] = {
+    [SP_BIN_MAX] = "",
+    [SP_BIN_MEAN] = "MEAN",
+    [SP_BIN_OCCUPANCY] = "OCC",
+};
+
 static Band *range;
 static uint16_t step;
 
@@ -41,11 +148,148 @@ void UI_DrawTicks(uint8_t y, const Band *band) {
   }
 }
 
+static void markAllChanged(void) {
+  for (uint8_t i = 0; i < ARRAY_SIZE(changedCols); ++i) {
+    changedCols[i] = UINT32_MAX;
+  }
+}
+
+static void recalcStats(void) {
+  sumSq = 0;
+  histMax = 0;
+  histMin = UINT16_MAX;
+  for (uint8_t i = 0; i < MAX_POINTS; ++i) {
+    uint16_t v = rssiHistory[i];
+    sumSq += (uint32_t)v * v;
+    if (v > histMax)
+      histMax = v;
+    if (v && v < histMin)
+      histMin = v;
+  }
+  extremaStale = false;
+}
+
+static void setColumn(uint8_t i, uint16_t v) {
+  uint16_t old = rssiHistory[i];
+  if (old == v) {
+    return;
+  }
+  rssiHistory[i] = v;
+  sumSq = sumSq - (uint32_t)old * old + (uint32_t)v * v;
+
+  if ((old == histMax && v < old) || (old == histMin && v > old)) {
+    extremaStale = true;
+  }
+  if (v > histMax)
+    histMax = v;
+  if (v && v < histMin)
+    histMin = v;
+
+  changedCols[i >> 5] |= 1UL << (i & 31);
+}
+
+static void updateExtrema(void) {
+  if (extremaStale) {
+    recalcStats();
+  }
+}
+
+static uint16_t traceValue(uint8_t i) {
+  return traceMode == SP_TRACE_AVERAGE ? traceAcc[i] >> AVG_SHIFT
+                                       : traceAcc[i];
+}
+
+static void traceReset(void) {
+  memset(traceAcc, 0, sizeof(traceAcc));
+  traceMax = 0;
+  traceMin = UINT16_MAX;
+}
+
+// O(MAX_POINTS), раз за проход
+static void traceRecalc(void) {
+  traceMax = 0;
+  traceMin = UINT16_MAX;
+  if (traceMode == SP_TRACE_LIVE) {
+    return;
+  }
+  for (uint8_t i = 0; i < MAX_POINTS; ++i) {
+    uint16_t tv = traceValue(i);
+    if (tv > traceMax)
+      traceMax = tv;
+    if (tv && tv < traceMin)
+      traceMin = tv;
+  }
+}
+
+// O(1): одна операция над накопителем столбца
+static void traceUpdate(uint8_t i) {
+  uint16_t v = rssiHistory[i];
+  uint16_t acc = traceAcc[i];
+
+  switch (traceMode) {
+  case SP_TRACE_MAX_HOLD:
+    if (v > acc)
+      acc = v;
+    break;
+  case SP_TRACE_MIN_HOLD:
+    if (v && (!acc || v < acc))
+      acc = v;
+    break;
+  case SP_TRACE_AVERAGE:
+    if (!acc) {
+      acc = v << AVG_SHIFT;
+    } else {
+      acc += ((int32_t)(v << AVG_SHIFT) - acc) / (1 << AVG_K);
+    }
+    break;
+  case SP_TRACE_LIVE:
+  case SP_TRACE_COUNT:
+    return;
+  }
+
+  if (acc != traceAcc[i]) {
+    traceAcc[i] = acc;
+    changedCols[i >> 5] |= 1UL << (i & 31);
+
+    uint16_t tv = traceValue(i);
+    if (tv > traceMax)
+      traceMax = tv;
+    if (tv && tv < traceMin)
+      traceMin = tv;
+  }
+}
+
+void SP_SetTrace(SpectrumTrace mode, bool overlay) {
+  if (mode != traceMode) {
+    traceMode = mode;
+    traceReset();
+  }
+  traceOverlay = overlay;
+  markAllChanged();
+}
+
+SpectrumTrace SP_GetTrace(void) { return traceMode; }
+bool SP_GetTraceOverlay(void) { return traceOverlay; }
+const char *SP_TraceName(void) { return TRACE_NAMES[traceMode]; }
+
+void SP_SetBin(SpectrumBin mode) {
+  binMode = mode;
+  SP_ResetHistory();
+  SP_Begin();
+}
+
+SpectrumBin SP_GetBin(void) { return binMode; }
+const char *SP_BinName(void) { return BIN_NAMES[binMode]; }
+
 void SP_ResetHistory(void) {
   filledPoints = 0;
   for (uint8_t i = 0; i < MAX_POINTS; ++i) {
     rssiHistory[i] = 0;
   }
+  memset(occupancy, 0, sizeof(occupancy));
+  traceReset();
+  recalcStats();
+  markAllChanged();
 }
 
 void SP_Begin(void) {
@@ -53,12 +297,55 @@ void SP_Begin(void) {
   ox = UINT8_MAX;
 }
 
+// Столбец, с которого начинается шаг binS + 1: остаток копится по
+// MAX_POINTS, за весь проход цикл делает не больше MAX_POINTS итераций
+static void binNextBoundary(void) {
+  binNextX = binX;
+  binNextRem = binRem + MAX_POINTS;
+  while (binNextRem >= stepsTotal) {
+    binNextRem -= stepsTotal;
+    binNextX++;
+  }
+}
+
+static void binSeekReset(void) {
+  binS = 0;
+  binX = 0;
+  binRem = 0;
+  binNextBoundary();
+}
+
 void SP_Init(Band *b) {
   S_BOTTOM = SPECTRUM_Y + SPECTRUM_H;
   range = b;
   step = StepFrequencyTable[b->step];
+  stepsTotal = step ? (b->txF - b->rxF) / step + 1 : 1;
+  binSeekReset();
+  binThreshold = UINT16_MAX;
+  sweepSum = 0;
+  sweepCount = 0;
   SP_ResetHistory();
   SP_Begin();
+  WF_Reset();
+}
+
+// Проход по диапазону закончен: строка в водопад
+void SP_EndSweep(void) {
+  if (ox < MAX_POINTS) {
+    traceUpdate(ox);
+    ox = UINT8_MAX;
+  }
+  traceRecalc();
+  if (sweepCount) {
+    binThreshold = sweepSum / sweepCount + BIN_MARGIN;
+    sweepSum = 0;
+    sweepCount = 0;
+  }
+  if (WF_IsEnabled()) {
+    WF_PushRow(rssiHistory, filledPoints, SP_GetNoiseFloor(),
+               SP_GetMinMax().vMax);
+    UI_Invalidate(WIDGET_WATERFALL);
+  }
 }
 
 /* uint8_t SP_F2X(uint32_t f) {
@@ -69,69 +356,94 @@ void SP_Init(Band *b) {
   return ConvertDomainF(x, 0, MAX_POINTS - 1, range->rxF, range->txF);
 } */
 
+// Те же столбцы, что у SP_AddPoint: шаг на несколько столбцов - середина
 uint8_t SP_F2X(uint32_t f) {
-  // 1. Проверка границ (Clamp)
-  if (f <= range->rxF)
-    return 0;
-  if (f >= range->txF)
-    return MAX_POINTS - 1;
-
-  uint32_t delta = f - range->rxF;
-  uint32_t aRange = range->txF - range->rxF;
+  uint32_t s = f > range->rxF && step ? (f - range->rxF) / step : 0;
+  if (s >= stepsTotal)
+    s = stepsTotal - 1;
 
-  // Вместо: (delta * 127) / aRange
-  // Делаем: delta / (aRange / 127)
-
-  // Предварительно считаем делитель (шаг частоты на 1 пиксель)
-  // +1 для округления вверх, чтобы не делить на 0, если диапазон схлопнут
-  uint32_t step = aRange / (MAX_POINTS - 1);
-
-  if (step == 0)
-    return 0; // Защита
-
-  // Результат гарантированно < 128, так как delta < aRange
-  return delta / step;
+  uint8_t xs = (uint64_t)s * MAX_POINTS / stepsTotal;
+  uint8_t xe = (uint64_t)(s + 1) * MAX_POINTS / stepsTotal; // не включая
+  return xe > xs + 1 ? (xs + xe - 1) / 2 : xs;
 }
 
+// Обратное к SP_F2X: шаг, попадающий в столбец x (первый, если их несколько)
 uint32_t SP_X2F(uint8_t x) {
-  // Защита от выхода за массив (хотя uint8_t x вряд ли превысит, если
-  // MAX_POINTS > 255)
   if (x >= MAX_POINTS)
     x = MAX_POINTS - 1;
 
-  // Считаем шаг частоты на один пиксель
-  // Лучше вынести расчет step в место, где меняется range, чтобы не делить
-  // каждый раз!
-  uint32_t step = (range->txF - range->rxF) / (MAX_POINTS - 1);
+  uint64_t n = (uint64_t)x * stepsTotal;
+  uint32_t s = stepsTotal < MAX_POINTS ? n / MAX_POINTS
+                                       : (n + MAX_POINTS - 1) / MAX_POINTS;
+  return range->rxF + s * step;
+}
+
+static void binSeek(uint32_t s) {
+  if (s == binS) {
+    return;
+  }
+  if (s == binS + 1) {
+    binX = binNextX;
+    binRem = binNextRem;
+  } else if (!s) {
+    binX = 0;
+    binRem = 0;
+  } else {
+    // скачок не по порядку - одно деление
+    uint64_t n = (uint64_t)s * MAX_POINTS;
+    binX = n / stepsTotal;
+    binRem = n % stepsTotal;
+  }
+  binS = s;
+  binNextBoundary();
+}
+
+static uint16_t binValue(void) {
+  return binMode == SP_BIN_MEAN ? (binSum + binCount / 2) / binCount : binMax;
+}
 
-  return range->rxF + (x * step);
+static void setOccupancy(uint8_t i, uint8_t v) {
+  if (occupancy[i] != v) {
+    occupancy[i] = v;
+    changedCols[i >> 5] |= 1UL << (i & 31);
+  }
 }
 
 void SP_AddPoint(const Measurement *msm) {
-  uint8_t xs = SP_F2X(msm->f);
-  uint8_t xe = SP_F2X(msm->f + step);
+  uint32_t s = msm->f > range->rxF ? (msm->f - range->rxF) / step : 0;
+  if (s >= stepsTotal)
+    s = stepsTotal - 1;
 
-  // Обрезаем индексы по диапазону допустимых значений
-  if (xs >= MAX_POINTS)
-    xs = MAX_POINTS - 1;
-  if (xe >= MAX_POINTS)
-    xe = MAX_POINTS - 1;
+  binSeek(s);
+  uint8_t xs = binX;
+  uint8_t xe = binNextX > binX ? binNextX - 1 : binX;
 
-  // Если xs > xe, меняем местами
-  if (xs > xe) {
-    uint8_t temp = xs;
-    xs = xe;
-    xe = temp;
-  }
+  const uint16_t rssi = msm->rssi;
+  sweepSum += rssi;
+  sweepCount++;
 
-  // TODO: debug this range
-  for (x = xs; x < MAX_POINTS && x <= xe; ++x) {
+  for (x = xs; x <= xe; ++x) {
+    // Новый столбец получает значение сразу, без промежуточного нуля,
+    // чтобы не сбивать экстремумы
     if (ox != x) {
+      if (ox < MAX_POINTS) {
+        traceUpdate(ox);
+      }
       ox = x;
-      rssiHistory[x] = 0;
+      binSum = 0;
+      binCount = 0;
+      binAbove = 0;
+      binMax = 0;
     }
-    if (msm->rssi > rssiHistory[x]) {
-      rssiHistory[x] = msm->rssi;
+    binSum += rssi;
+    binCount++;
+    if (rssi >= binThreshold)
+      binAbove++;
+    if (rssi > binMax)
+      binMax = rssi;
+    setColumn(x, binValue());
+    if (binMode == SP_BIN_OCCUPANCY) {
+      setOccupancy(x, binAbove * BIN_PERCENT / binCount);
     }
   }
   // not x+1 as we going to xe inclusive
@@ -143,19 +455,6 @@ void SP_AddPoint(const Measurement *msm) {
   }
 }
 
-static uint16_t MinRSSI(const uint16_t *array, size_t n) {
-  if (array == NULL || n == 0) {
-    return 0;
-  }
-  uint16_t min = array[0];
-  for (size_t i = 1; i < n; ++i) {
-    if (array[i] && array[i] < min) {
-      min = array[i];
-    }
-  }
-  return min;
-}
-
 /* VMinMax SP_GetMinMax() {
   const uint16_t rssiMin = MinRSSI(rssiHistory, filledPoints);
   const uint16_t rssiMax = Max(rssiHistory, filledPoints);
@@ -169,8 +468,9 @@ static uint16_t MinRSSI(const uint16_t *array, size_t n) {
 #define _MAX(a, b) (((a) > (b)) ? (a) : (b))
 
 VMinMax SP_GetMinMax() {
-  const uint16_t rssiMin = MinRSSI(rssiHistory, filledPoints);
-  const uint16_t rssiMax = Max(rssiHistory, filledPoints);
+  updateExtrema();
+  const uint16_t rssiMin = histMin == UINT16_MAX ? 0 : histMin;
+  const uint16_t rssiMax = histMax;
   const uint16_t noiseFloor = SP_GetNoiseFloor();
   const uint16_t rssiDiff = rssiMax - rssiMin;
 
@@ -183,9 +483,46 @@ VMinMax SP_GetMinMax() {
     vMax = noiseFloor + 40;
   }
 
+  // Трасса может выходить за живой проход: пики max-hold выше, min-hold ниже
+  if (traceMode != SP_TRACE_LIVE && traceMin <= traceMax) {
+    if (traceMin <= vMin)
+      vMin = traceMin - 1;
+    if (traceMax > vMax)
+      vMax = traceMax;
+  }
+
   return (VMinMax){.vMin = vMin, .vMax = vMax};
 }
 
+static uint8_t scaleBar(uint16_t rssi) {
+  if (rssi <= barScaleV.vMin) {
+    return 0;
+  }
+  if (rssi >= barScaleV.vMax) {
+    return barScaleH;
+  }
+  return ((rssi - barScaleV.vMin) * barScaleQ16 + 0x8000) >> 16;
+}
+
+// Столбцы - живой проход или выбранная трасса; в режиме наложения трасса
+// идёт линией поверх живых столбцов (инверсией, чтобы видеть и внутри них)
+static void renderTraceLine(void) {
+  uint8_t py = 0;
+  for (uint8_t i = 0; i < filledPoints; ++i) {
+    uint8_t y = S_BOTTOM - scaleBar(traceValue(i));
+    if (!i)
+      py = y;
+    if (y < py) {
+      DrawVLine(i, y, py - y + 1, C_INVERT);
+    } else {
+      DrawVLine(i, py, y - py + 1, C_INVERT);
+    }
+    py = y;
+  }
+}
+
+// Высоты пересчитываются только у изменившихся столбцов; при смене шкалы -
+// у всех. Рисуются все: область спектра стирается виджетом целиком
 void SP_Render(const Band *p, VMinMax v) {
   if (p) {
     UI_DrawTicks(S_BOTTOM, p);
@@ -193,9 +530,34 @@ void SP_Render(const Band *p, VMinMax v) {
 
   DrawHLine(0, S_BOTTOM, MAX_POINTS, C_FILL);
 
+  if (v.vMin != barScaleV.vMin || v.vMax != barScaleV.vMax ||
+      SPECTRUM_H != barScaleH) {
+    barScaleV = v;
+    barScaleH = SPECTRUM_H;
+    barScaleQ16 = v.vMax > v.vMin
+                      ? ((uint32_t)SPECTRUM_H << 16) / (v.vMax - v.vMin)
+                      : 0;
+    markAllChanged();
+  }
+
+  // занятость всегда столбцами, трасса к ней - линией
+  const bool occBars = binMode == SP_BIN_OCCUPANCY;
+  const bool liveBars = traceMode == SP_TRACE_LIVE || traceOverlay;
   for (uint8_t i = 0; i < filledPoints; ++i) {
-    uint8_t yVal = ConvertDomain(rssiHistory[i], v.vMin, v.vMax, 0, SPECTRUM_H);
-    DrawVLine(i, S_BOTTOM - yVal, yVal, C_FILL);
+    if (changedCols[i >> 5] & (1UL << (i & 31))) {
+      barH[i] = occBars    ? occupancy[i] * SPECTRUM_H / BIN_PERCENT
+                : liveBars ? scaleBar(rssiHistory[i])
+                           : scaleBar(traceValue(i));
+    }
+    DrawVLine(i, S_BOTTOM - barH[i], barH[i], C_FILL);
+  }
+
+  if (traceMode != SP_TRACE_LIVE && (traceOverlay || occBars)) {
+    renderTraceLine();
+  }
+
+  for (uint8_t i = 0; i < ARRAY_SIZE(changedCols); ++i) {
+    changedCols[i] = 0;
   }
 }
 
@@ -332,10 +694,26 @@ void SP_RenderLine(uint16_t rssi, VMinMax v) {
   DrawHLine(0, S_BOTTOM - yVal, filledPoints, C_FILL);
 }
 
-uint16_t SP_GetNoiseFloor() { return Std(rssiHistory, filledPoints); }
-uint16_t SP_GetRssiMax() { return Max(rssiHistory, filledPoints); }
+uint16_t SP_GetNoiseFloor() {
+  return filledPoints ? Sqrt(sumSq / filledPoints) : 0;
+}
 
-uint16_t SP_GetLastGraphValue() { return rssiGraphHistory[MAX_POINTS - 1]; }
+uint16_t SP_GetRssiMax() {
+  updateExtrema();
+  return histMax;
+}
+
+static uint8_t graphSample(const GraphRing *g, uint8_t age) {
+  uint8_t i = g->head + g->len - 1 - age;
+  if (i >= g->len)
+    i -= g->len;
+  return g->data[i][graphMeasurement];
+}
+
+uint16_t SP_GetLastGraphValue() {
+  const GraphRing *g = &graphRings[graphTimeBase];
+  return g->count ? graphSample(g, 0) : 0;
+}
 
 void SP_RenderGraph(uint16_t min, uint16_t max) {
   const VMinMax v = {
@@ -348,13 +726,20 @@ void SP_RenderGraph(uint16_t min, uint16_t max) {
 
   FillRect(0, SPECTRUM_Y, LCD_WIDTH, SPECTRUM_H, C_CLEAR);
 
-  uint8_t oVal =
-      ConvertDomain(rssiGraphHistory[0], v.vMin, v.vMax, 0, SPECTRUM_H);
+  // Новые точки справа, обход кольца от головы назад
+  const GraphRing *g = &graphRings[graphTimeBase];
+  const uint8_t px = MAX_POINTS / g->len;
+  uint8_t prevX = MAX_POINTS - 1;
+  uint8_t oVal = 0;
 
-  for (uint8_t i = 1; i < MAX_POINTS; ++i) {
+  for (uint8_t age = 0; age < g->count; ++age) {
+    uint8_t gx = MAX_POINTS - 1 - age * px;
     uint8_t yVal =
-        ConvertDomain(rssiGraphHistory[i], v.vMin, v.vMax, 0, SPECTRUM_H);
-    DrawLine(i - 1, S_BOTTOM - oVal, i, S_BOTTOM - yVal, C_FILL);
+        ConvertDomain(graphSample(g, age), v.vMin, v.vMax, 0, SPECTRUM_H);
+    if (age) {
+      DrawLine(gx, S_BOTTOM - yVal, prevX, S_BOTTOM - oVal, C_FILL);
+    }
+    prevX = gx;
     oVal = yVal;
   }
   DrawHLine(0, SPECTRUM_Y, LCD_WIDTH, C_FILL);
@@ -369,26 +754,58 @@ void SP_NextGraphUnit(bool next) {
   graphMeasurement = IncDecU(graphMeasurement, 0, GRAPH_COUNT, next);
 }
 
+void SP_NextGraphBase(bool next) {
+  graphTimeBase = IncDecU(graphTimeBase, 0, GRAPH_BASE_COUNT, next);
+}
+
+const char *SP_GraphBaseName(void) { return GRAPH_BASE_NAMES[graphTimeBase]; }
+
+static void graphPush(GraphRing *g, const uint8_t *s) {
+  memcpy(g->data[g->head], s, sizeof(GraphSample));
+  if (++g->head == g->len)
+    g->head = 0;
+  if (g->count < g->len)
+    g->count++;
+}
+
+// O(серий) на замер: запись в голову кольца, без сдвига массивов
 void SP_AddGraphPoint(const Measurement *msm) {
-  uint16_t v = msm->rssi;
+  const uint16_t v[GRAPH_COUNT] = {
+      [GRAPH_RSSI] = msm->rssi,
+      [GRAPH_NOISE] = msm->noise,
+      [GRAPH_GLITCH] = msm->glitch,
+      [GRAPH_SNR] = msm->snr,
+  };
+  GraphSample s;
+  const uint32_t now = Now();
 
-  switch (graphMeasurement) {
-  case GRAPH_NOISE:
-    v = msm->noise;
-    break;
-  case GRAPH_GLITCH:
-    v = msm->glitch;
-    break;
-  case GRAPH_SNR:
-    v = msm->snr;
-    break;
-  case GRAPH_RSSI:
-  case GRAPH_COUNT:
-    break;
+  for (uint8_t m = 0; m < GRAPH_COUNT; ++m) {
+    s[m] = v[m] > UINT8_MAX ? UINT8_MAX : v[m];
   }
+  graphPush(&graphRings[GRAPH_BASE_FAST], s);
 
-  rssiGraphHistory[MAX_POINTS - 1] = v;
-  filledPoints = MAX_POINTS;
+  for (uint8_t b = GRAPH_BASE_FAST + 1; b < GRAPH_BASE_COUNT; ++b) {
+    GraphRing *g = &graphRings[b];
+    for (uint8_t m = 0; m < GRAPH_COUNT; ++m) {
+      g->sum[m] += s[m];
+    }
+    g->n++;
+    if (!g->next) {
+      g->next = now + g->periodMs;
+    }
+    // n ограничен, чтобы сумма не переполнилась при редких замерах
+    if ((int32_t)(now - g->next) < 0 && g->n < UINT8_MAX) {
+      continue;
+    }
+    GraphSample avg;
+    for (uint8_t m = 0; m < GRAPH_COUNT; ++m) {
+      avg[m] = g->sum[m] / g->n;
+      g->sum[m] = 0;
+    }
+    g->n = 0;
+    g->next = now + g->periodMs;
+    graphPush(g, avg);
+  }
 }
 
 static void shiftEx(uint16_t *history, uint16_t n, int16_t shift) {
@@ -412,8 +829,25 @@ static void shiftEx(uint16_t *history, uint16_t n, int16_t shift) {
   }
 }
 
-void SP_Shift(int16_t n) { shiftEx(rssiHistory, MAX_POINTS, n); }
-void SP_ShiftGraph(int16_t n) { shiftEx(rssiGraphHistory, MAX_POINTS, n); }
+static void shiftOccupancy(int16_t n) {
+  if (n >= MAX_POINTS || n <= -MAX_POINTS) {
+    memset(occupancy, 0, sizeof(occupancy));
+  } else if (n > 0) {
+    memmove(occupancy + n, occupancy, MAX_POINTS - n);
+    memset(occupancy, 0, n);
+  } else if (n < 0) {
+    memmove(occupancy, occupancy - n, MAX_POINTS + n);
+    memset(occupancy + MAX_POINTS + n, 0, -n);
+  }
+}
+
+void SP_Shift(int16_t n) {
+  shiftEx(rssiHistory, MAX_POINTS, n);
+  shiftEx(traceAcc, MAX_POINTS, n);
+  shiftOccupancy(n);
+  recalcStats();
+  markAllChanged();
+}
 
 static uint8_t curX = MAX_POINTS / 2;
 static uint8_t curSbWidth = 16;
@@ -11,6 +11,21 @@ typedef struct {
   uint16_t vMax;
 } VMinMax;
 
+typedef enum {
+  SP_TRACE_LIVE,
+  SP_TRACE_MAX_HOLD,
+  SP_TRACE_AVERAGE,
+  SP_TRACE_MIN_HOLD,
+  SP_TRACE_COUNT,
+} SpectrumTrace;
+
+typedef enum {
+  SP_BIN_MAX,
+  SP_BIN_MEAN,
+  SP_BIN_OCCUPANCY,
+  SP_BIN_COUNT,
+} SpectrumBin;
+
 typedef enum {
   GRAPH_RSSI,
   GRAPH_NOISE,
@@ -19,10 +34,25 @@ typedef enum {
   GRAPH_COUNT,
 } GraphMeasurement;
 
+typedef enum {
+  GRAPH_BASE_FAST, // каждый замер, SQL_DELAY
+  GRAPH_BASE_1S,
+  GRAPH_BASE_10S,
+  GRAPH_BASE_COUNT,
+} GraphTimeBase;
+
 void SP_AddPoint(const Measurement *msm);
 void SP_ResetHistory();
 void SP_Init(Band *b);
 void SP_Begin();
+void SP_EndSweep(void);
+void SP_SetTrace(SpectrumTrace mode, bool overlay);
+SpectrumTrace SP_GetTrace(void);
+bool SP_GetTraceOverlay(void);
+const char *SP_TraceName(void);
+void SP_SetBin(SpectrumBin mode);
+SpectrumBin SP_GetBin(void);
+const char *SP_BinName(void);
 void SP_Render(const Band *p, VMinMax v);
 void SP_RenderRssi(uint16_t rssi, char *text, bool top, VMinMax v);
 void SP_RenderLine(uint16_t rssi, VMinMax v);
@@ -32,10 +62,11 @@ uint16_t SP_GetRssiMax();
 VMinMax SP_GetMinMax();
 
 void SP_NextGraphUnit(bool next);
+void SP_NextGraphBase(bool next);
+const char *SP_GraphBaseName(void);
 void SP_RenderGraph(uint16_t min, uint16_t max);
 void SP_AddGraphPoint(const Measurement *msm);
 void SP_Shift(int16_t n);
-void SP_ShiftGraph(int16_t n);
 uint16_t SP_GetLastGraphValue();
 
 uint8_t SP_F2X(uint32_t f);
@@ -50,5 +81,6 @@ bool CUR_Size(bool up);
 extern uint8_t SPECTRUM_Y;
 extern uint8_t SPECTRUM_H;
 extern GraphMeasurement graphMeasurement;
+extern GraphTimeBase graphTimeBase;
 
 #endif /* end of include guard: UI_SPECTRUM_H */
@@ -10,6 +10,7 @@
 #include "../scheduler.h"
 #include "components.h"
 #include "graphics.h"
+#include "widgets.h"
 #include <string.h>
 
 static uint8_t previousBatteryLevel = 255;
@@ -29,7 +30,7 @@ void STATUSLINE_SetText(const char *pattern, ...) {
   va_end(args);
   if (strcmp(statuslineText, statuslineTextNew)) {
     strcpy(statuslineText, statuslineTextNew);
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_STATUS);
   }
 }
 
@@ -38,22 +39,22 @@ void STATUSLINE_update(void) {
   uint8_t level = gBatteryPercent / 10;
   if (gBatteryPercent < BAT_WARN_PERCENT) {
     showBattery = !showBattery;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_STATUS);
   } else {
     showBattery = true;
   }
   if (previousBatteryLevel != level) {
     previousBatteryLevel = level;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_STATUS);
   }
 
   if ((bool)lastEepromWrite != gEepromWrite) {
     lastEepromWrite = gEepromWrite ? Now() : 0;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_STATUS);
   }
   if (lastEepromWrite && Now() - lastEepromWrite > 500) {
     lastEepromWrite = gEepromWrite = false;
-    gRedrawScreen = true;
+    UI_Invalidate(WIDGET_STATUS);
   }
 
   if (Now() - lastTickerUpdate > 5000) {
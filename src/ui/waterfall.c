@@ -0,0 +1,120 @@
+#include "waterfall.h"
+#include "../driver/st7565.h"
+#include <string.h>
+
+// Кольцо прошедших проходов спектра, по 4 уровня на столбец. Новый проход -
+// одна строка, память и время отрисовки не зависят от длины прохода
+
+#define WF_COLS LCD_WIDTH
+#define WF_ROW_BYTES (WF_COLS / 4)
+
+static uint8_t rows[WF_ROWS][WF_ROW_BYTES];
+static uint8_t head;    // последняя записанная строка
+static uint8_t count;
+static uint8_t pending; // записано, но ещё не выведено на экран
+static bool enabled;
+
+// Упорядоченный дизеринг 4x4: уровень 1..3 зажигает 5, 10 и 16 точек из 16.
+// Строка матрицы берётся по номеру строки кольца, а не по возрасту, - при
+// прокрутке уже выведенные точки остаются верными
+static const uint8_t BAYER[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+void WF_Reset(void) {
+  memset(rows, 0, sizeof(rows));
+  head = 0;
+  count = 0;
+  pending = 0;
+}
+
+void WF_SetEnabled(bool e) {
+  enabled = e;
+  WF_Reset();
+}
+
+bool WF_IsEnabled(void) { return enabled; }
+
+// lo - уровень, ниже которого столбец пустой (шум), hi - полная яркость
+void WF_PushRow(const uint16_t *values, uint8_t n, uint16_t lo, uint16_t hi) {
+  if (!enabled) {
+    return;
+  }
+
+  head = (head + 1) % WF_ROWS;
+  if (count < WF_ROWS) {
+    count++;
+  }
+  if (pending < WF_ROWS) {
+    pending++;
+  }
+
+  uint8_t *row = rows[head];
+  uint16_t range = hi > lo ? hi - lo : 1;
+  memset(row, 0, WF_ROW_BYTES);
+
+  for (uint8_t x = 0; x < n && x < WF_COLS; ++x) {
+    if (values[x] <= lo) {
+      continue;
+    }
+    uint16_t level = (uint32_t)(values[x] - lo) * 4 / range;
+    if (level > 3) {
+      level = 3;
+    }
+    row[x >> 2] |= level << ((x & 3) * 2);
+  }
+}
+
+static uint8_t pixel(uint8_t age, uint8_t x) {
+  uint8_t r = (head + WF_ROWS - age) % WF_ROWS;
+  uint8_t level = (rows[r][x >> 2] >> ((x & 3) * 2)) & 3;
+  return BAYER[r & 3][x & 3] < level * 16 / 3;
+}
+
+// Полная отрисовка: новый проход сверху, байт страницы собирается сразу из
+// 8 строк кольца
+void WF_Render(uint8_t page) {
+  if (!enabled) {
+    return;
+  }
+
+  for (uint8_t p = 0; p < WF_PAGES; ++p) {
+    uint8_t *dst = gFrameBuffer[page + p];
+    for (uint8_t x = 0; x < WF_COLS; ++x) {
+      uint8_t b = 0;
+      for (uint8_t bit = 0; bit < 8 && p * 8 + bit < count; ++bit) {
+        b |= pixel(p * 8 + bit, x) << bit;
+      }
+      dst[x] = b;
+    }
+    ST7565_MarkDirty(page + p, 0, WF_COLS - 1);
+  }
+  pending = 0;
+}
+
+// Дорисовка: страницы сдвигаются вниз на строку, сверху встаёт новый проход.
+// Старые строки не пересчитываются
+void WF_Scroll(uint8_t page) {
+  if (!enabled || !pending) {
+    return;
+  }
+
+  while (pending) {
+    pending--;
+    for (uint8_t x = 0; x < WF_COLS; ++x) {
+      // снизу вверх: старший бит страницы переносится в младший следующей
+      for (uint8_t p = WF_PAGES - 1; p > 0; --p) {
+        gFrameBuffer[page + p][x] = (gFrameBuffer[page + p][x] << 1) |
+                                    (gFrameBuffer[page + p - 1][x] >> 7);
+      }
+      gFrameBuffer[page][x] = (gFrameBuffer[page][x] << 1) | pixel(pending, x);
+    }
+  }
+
+  for (uint8_t p = 0; p < WF_PAGES; ++p) {
+    ST7565_MarkDirty(page + p, 0, WF_COLS - 1);
+  }
+}
@@ -0,0 +1,19 @@
+#ifndef UI_WATERFALL_H
+#define UI_WATERFALL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Строк на экране и в кольце: 3 страницы дисплея, 2 бита на столбец -
+// 32 байта на проход, 768 байт на всю историю
+#define WF_ROWS 24
+#define WF_PAGES (WF_ROWS / 8)
+
+void WF_Reset(void);
+void WF_SetEnabled(bool enabled);
+bool WF_IsEnabled(void);
+void WF_PushRow(const uint16_t *values, uint8_t n, uint16_t lo, uint16_t hi);
+void WF_Render(uint8_t page);
+void WF_Scroll(uint8_t page);
+
+#endif /* end of include guard: UI_WATERFALL_H */
@@ -0,0 +1,32 @@
+#include "widgets.h"
+#include "../driver/st7565.h"
+#include "graphics.h"
+
+uint8_t gDirtyWidgets;
+
+// Стирает и рисует заново только отмеченные области, области с update
+// дорисовываются без стирания. false - в маске есть область, которой у
+// приложения нет, нужна полная перерисовка
+bool UI_RenderWidgets(const Widget *widgets, uint8_t count, uint8_t mask) {
+  uint8_t known = WIDGET_STATUS;
+  for (uint8_t i = 0; i < count; ++i) {
+    known |= widgets[i].id;
+  }
+  if (mask & ~known) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < count; ++i) {
+    const Widget *w = &widgets[i];
+    if (!(mask & w->id)) {
+      continue;
+    }
+    if (w->update) {
+      w->update();
+    } else {
+      FillRect(0, w->y, LCD_WIDTH, w->h, C_CLEAR);
+      w->render();
+    }
+  }
+  return true;
+}
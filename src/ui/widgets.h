@@ -0,0 +1,34 @@
+#ifndef UI_WIDGETS_H
+#define UI_WIDGETS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Области экрана с собственной отметкой "перерисовать". Приложение описывает
+// свои области массивом Widget; область, которой у приложения нет, ведёт к
+// полной перерисовке, как gRedrawScreen
+typedef enum {
+  WIDGET_SPECTRUM = 1 << 0,  // спектр с надписями поверх
+  WIDGET_FREQ = 1 << 1,      // строка частот
+  WIDGET_WATERFALL = 1 << 2, // водопад, новая строка на каждый проход
+  WIDGET_LOOT = 1 << 3,      // строка последней находки
+  WIDGET_MENU = 1 << 4,      // строки меню
+  WIDGET_STATUS = 1 << 7,    // статусная строка, есть везде
+} WidgetId;
+
+typedef struct {
+  uint8_t id; // WidgetId
+  uint8_t y;
+  uint8_t h;
+  void (*render)(void);
+  // дорисовка поверх прошлого кадра без стирания; NULL - стереть и render
+  void (*update)(void);
+} Widget;
+
+extern uint8_t gDirtyWidgets;
+
+static inline void UI_Invalidate(uint8_t mask) { gDirtyWidgets |= mask; }
+
+bool UI_RenderWidgets(const Widget *widgets, uint8_t count, uint8_t mask);
+
+#endif /* end of include guard: UI_WIDGETS_H */
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Decode binary trace frames (0x0550) from a hawk5 debug build.
+
+Usage: tracelog.py /dev/ttyUSB0 [--header src/helper/trace.h]
+       tracelog.py /dev/ttyUSB0 --prof [--reset]
+
+Event table is generated from TRACE_EVENTS in trace.h, so ids and format
+strings always match the firmware they were built from.
+"""
+import argparse
+import os
+import re
+import sys
+from struct import pack, unpack_from
+
+import serial
+
+from spectrum import read_frame, send_command, wait_reply
+
+ENTRY = "<IHHII"  # t, id, a, b, c
+ENTRY_SIZE = 16
+
+
+def load_events(header):
+    """[(name, fmt)] in enum order from TRACE_EVENTS X-macro"""
+    src = open(header).read()
+    return re.findall(r'X\((TR_\w+),\s*"((?:[^"\\]|\\.)*)"\)', src)
+
+
+def render(fmt, a, b, c):
+    env = {"a": a, "b": b, "c": c}
+
+    def field(m):
+        value = eval(m.group(1), {}, env)
+        return format(value, m.group(2) or "")
+
+    return re.sub(r"\{([^{}:]+)(?::([^{}]+))?\}", field, fmt)
+
+
+PROF_NAMES = ["SET", "SCAN", "APP", "KEY", "SYS", "DRAW", "UART", "LOOP"]
+
+
+def print_prof(port, reset=False):
+    """Main loop latency histograms (0x0546)"""
+    send_command(port, pack("<HHB3x", 0x0546, 4, int(reset)))
+    payload = wait_reply(port, 0x0547)
+    stages, buckets = unpack_from("<BB", payload, 4)
+    size = 8 + buckets
+    print(f"{'stage':6} {'count':>9} {'max us':>8}  histogram <1us .. >={1 << (buckets - 1)}us")
+    for i in range(stages):
+        count, worst = unpack_from("<II", payload, 8 + i * size)
+        hist = payload[16 + i * size:16 + i * size + buckets]
+        peak = max(hist) or 1
+        bars = "".join(" .:-=+*#%@"[h * 9 // peak] for h in hist)
+        name = PROF_NAMES[i] if i < len(PROF_NAMES) else f"#{i}"
+        print(f"{name:6} {count:9} {worst:8}  |{bars}|")
+
+
+def main():
+    default_header = os.path.join(os.path.dirname(__file__), "src", "helper", "trace.h")
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("port")
+    ap.add_argument("--baud", type=int, default=38400)
+    ap.add_argument("--header", default=default_header)
+    ap.add_argument("--prof", action="store_true", help="print main loop latency histograms")
+    ap.add_argument("--reset", action="store_true", help="reset histograms after --prof")
+    args = ap.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=1)
+    if args.prof:
+        print_prof(port, args.reset)
+        return
+
+    events = load_events(args.header)
+
+    t0 = last = None
+    try:
+        while True:
+            payload = read_frame(port)
+            if payload is None or unpack_from("<H", payload)[0] != 0x0550:
+                continue
+            dropped, count = unpack_from("<HB", payload, 4)
+            if dropped:
+                print(f"{'':>12} ... {dropped} events dropped")
+            for i in range(count):
+                t, eid, a, b, c = unpack_from(ENTRY, payload, 8 + i * ENTRY_SIZE)
+                if t0 is None:
+                    t0 = last = t
+                dt = (t - last) & 0xFFFFFFFF
+                last = t
+                name, fmt = events[eid] if eid < len(events) else (f"#{eid}", "{a} {b} {c}")
+                print(f"{((t - t0) & 0xFFFFFFFF) / 1e6:12.6f} +{dt:7} {name:16} {render(fmt, a, b, c)}")
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()